@@ -16,6 +16,11 @@ extern std::unordered_map<TypeIndex, std::string> type_names;
 extern Object TypeError, UnionType;
 extern std::unordered_map<Object, Object> output_conversions, input_conversions, type_translations;
 extern std::unordered_map<std::type_index, Object> python_types;
+/// Whether heap held payloads created during each Function call come from a per-call Arena
+extern bool CallArena;
+
+/// Forget the compiled casts to Python type annotations, which depend on type_translations and output_conversions
+void clear_cast_plans() noexcept;
 
 /******************************************************************************/
 
@@ -27,6 +32,11 @@ std::nullptr_t type_error(char const *s, Ts ...ts) {PyErr_Format(TypeError, s, t
 struct Var : Variable {
     using Variable::Variable;
     Object ward = {};
+    /// Number of live buffers exporting the held value, which may not be moved or assigned meanwhile
+    std::size_t exports = 0;
+
+    /// Reference to the held value, which is const while a buffer of it is exported
+    Variable lend() {return exports ? static_cast<Variable const &>(*this).reference() : reference();}
 
     ~Var() {DUMP("~Var() ", ward, ", refcount = ", reference_count(ward));}
 };
@@ -34,19 +44,22 @@ struct Var : Variable {
 template <>
 struct Holder<Variable> : Holder<Var> {};
 
+template <>
+struct Holder<Function> : CallableHolder<Function> {};
+
 /******************************************************************************/
 
 struct ArrayBuffer {
     std::vector<Py_ssize_t> shape_stride;
     std::size_t exports = 0;
-    std::size_t n_elem;
+    ArrayLayout layout;
     Object base;
     void *data;
     std::type_info const * type;
     bool mutate;
 
     ArrayBuffer() noexcept = default;
-    ArrayBuffer(ArrayView const &a, Object const &b) : n_elem(a.layout.n_elem()),
+    ArrayBuffer(ArrayView const &a, Object const &b) : layout(a.layout),
         base(b), data(const_cast<void *>(a.data.pointer())), type(&a.data.type()), mutate(a.data.mutate()) {
         for (std::size_t i = 0; i != a.layout.depth(); ++i)
             shape_stride.emplace_back(a.layout.shape(i));
@@ -56,26 +69,37 @@ struct ArrayBuffer {
     }
 };
 
+/// Whether v is the value of the Variable root, which owns it as a contiguous array and exports it as a buffer
+bool is_owned_array(Variable const &v, Object const &root);
+
 /******************************************************************************/
 
 Variable variable_reference_from_object(Object o);
 void args_from_python(Sequence &s, Object const &pypack);
+void args_from_python(Sequence &s, PyObject *const *args, std::size_t n);
 bool object_response(Variable &v, TypeIndex t, Object o);
 
 template <Qualifier Q>
 struct Response<Object, Q> {
     bool operator()(Variable &v, TypeIndex t, Object o) const {
         DUMP("trying to get reference from qualified Object ", Q, ", type = ", t);
-        if (auto p = cast_if<Variable>(o)) {
+        if (auto p = cast_if<Var>(o)) {
             Dispatch msg;
             DUMP("requested qualified variable", t, p->type());
-            v = p->reference().request_variable(msg, t);
+            v = p->lend().request_variable(msg, t);
             DUMP(p->type(), t, v.type());
         }
         return v.has_value();
     }
 };
 
+/// Description of a Python type, evaluated only when an error message is built (with the GIL held).
+/// The type is borrowed: it must outlive the message, as the type of a call argument does
+Description describe_python_type(PyObject *type) noexcept;
+
+/// Return the Python type described by d if it was made by describe_python_type(), otherwise NULL
+PyObject *described_python_type(Description const &d) noexcept;
+
 template <>
 struct Response<Object, Value> {
     bool operator()(Variable &v, TypeIndex t, Object o) const {
@@ -91,11 +115,7 @@ struct Response<Object, Value> {
         DUMP("reference count 2 = ", reference_count(o));
         bool ok = object_response(v, t, std::move(o));
         DUMP("got response from object, ok = ", ok);
-        if (!ok) { // put diagnostic for the source type
-            auto o = Object::from(PyObject_Repr(+type));
-            DUMP("setting object error description: ", from_unicode(o));
-            v = {Type<std::string>(), from_unicode(o)};
-        }
+        if (!ok) v = describe_python_type(+type); // put diagnostic for the source type
         return ok;
     }
 };
@@ -130,6 +150,9 @@ Object args_as_tuple(Ts &&...ts) {
 
 Object variable_cast(Variable &&v, Object root={}, Object const &t={});
 
+Object python_cast(Variable &&v, Object const &t, Object root);
+
+/// Convert arguments to Python, casting the leading ones to the types in sig (None leaves an argument as is)
 inline Object args_to_python(Sequence &&s, Object const &sig={}) {
     if (sig && !PyTuple_Check(+sig))
         throw python_error(type_error("expected tuple but got %R", (+sig)->ob_type));
@@ -138,14 +161,11 @@ inline Object args_to_python(Sequence &&s, Object const &sig={}) {
     auto out = Object::from(PyTuple_New(n));
     Py_ssize_t i = 0u;
     for (auto &v : s) {
-        if (i < len) {
-            PyObject *t = PyTuple_GET_ITEM(+sig, i);
-            throw python_error(type_error("conversion to python signature not implemented yet"));
-        } else {
-            // special case: if given an rvalue reference, make it into a value
-            Variable &&var = v.qualifier() == Rvalue ? v.copy() : std::move(v);
-            if (!set_tuple_item(out, i, variable_cast(std::move(var)))) return {};
-        }
+        // special case: if given an rvalue reference, make it into a value
+        Variable &&var = v.qualifier() == Rvalue ? v.copy() : std::move(v);
+        PyObject *t = i < len ? PyTuple_GET_ITEM(+sig, i) : Py_None;
+        if (!set_tuple_item(out, i, t == Py_None ? variable_cast(std::move(var))
+            : python_cast(std::move(var), {t, true}, {}))) return {};
         ++i;
     }
     return out;
@@ -164,41 +184,61 @@ void map_iterable(Object iterable, F &&f) {
 
 /******************************************************************************/
 
-/// RAII release of Python GIL
+/// Frame of a call from Python, which releases the GIL when the call is entered if no_gil is set.
+/// The mutex serializes the threads calling back into Python while the GIL is released, and the recycling of the frame
 struct PythonFrame final : Frame {
+    static constexpr char tag = 0;
     std::mutex mutex;
     PyThreadState *state = nullptr;
-    bool no_gil;
+    std::atomic<bool> no_gil{false}; //< set after the generation is advanced, when the frame is taken for a call
 
-    PythonFrame(bool no_gil) : no_gil(no_gil) {}
+    PythonFrame() noexcept : Frame(&tag) {}
 
     void enter() override {
         DUMP("running with nogil=", no_gil);
-        if (no_gil && !state) state = PyEval_SaveThread(); // release GIL
-    }
-
-    std::shared_ptr<Frame> operator()(std::shared_ptr<Frame> &&t) override {
-        DUMP("suspended Python ", bool(t));
-        if (no_gil || state) return std::move(t); // return this
-        else return std::make_shared<PythonFrame>(no_gil); // return a new frame
+        if (no_gil.load(std::memory_order_relaxed) && !state) state = PyEval_SaveThread(); // release GIL
     }
+};
 
-    // acquire GIL; lock mutex to prevent multiple threads trying to get the thread going
-    void acquire() noexcept {if (state) {mutex.lock(); PyEval_RestoreThread(state);}}
-    // release GIL; unlock mutex
-    void release() noexcept {if (state) {state = PyEval_SaveThread(); mutex.unlock();}}
+/******************************************************************************/
 
-    ~PythonFrame() {if (state) PyEval_RestoreThread(state);}
+/// PythonFrame owned by the current thread for the duration of a call.
+/// Frames are taken from a per-thread pool and never freed, so expired Callers may still refer to them.
+class PythonFrameScope {
+    PythonFrame *frame;
+public:
+    explicit PythonFrameScope(bool no_gil);
+    /// Reacquire the GIL if it was released, expire the Callers of the frame and return it to the pool
+    ~PythonFrameScope();
+    PythonFrameScope(PythonFrameScope const &) = delete;
+    PythonFrameScope & operator=(PythonFrameScope const &) = delete;
+
+    Caller caller() const noexcept {return Caller(*frame);}
 };
 
 /******************************************************************************/
 
-/// RAII reacquisition of Python GIL
+/// RAII reacquisition of Python GIL by a Caller of the given frame; throws if the Caller has expired.
+/// If the GIL was released, the mutex is locked to prevent multiple threads trying to get the thread going,
+/// and the Caller is checked under it, since the owner recycles the frame under it too
 struct ActivePython {
-    PythonFrame &lock;
+    PythonFrame &frame;
+    bool const locked;
+
+    ActivePython(PythonFrame &f, Caller const &c) : frame(f), locked(f.no_gil.load(std::memory_order_acquire)) {
+        if (locked) frame.mutex.lock();
+        if (!c) {
+            if (locked) frame.mutex.unlock();
+            throw DispatchError("Python context is expired or invalid");
+        }
+        if (locked && frame.state) PyEval_RestoreThread(frame.state);
+    }
 
-    ActivePython(PythonFrame &u) : lock(u) {lock.acquire();}
-    ~ActivePython() {lock.release();}
+    ~ActivePython() {
+        if (!locked) return;
+        if (frame.state) frame.state = PyEval_SaveThread();
+        frame.mutex.unlock();
+    }
 };
 
 /******************************************************************************/
@@ -221,7 +261,7 @@ struct PythonFunction {
         DUMP("calling python function");
         auto p = c.target<PythonFrame>();
         if (!p) throw DispatchError("Python context is expired or invalid");
-        ActivePython lk(*p);
+        ActivePython lk(*p, c);
         Object o = args_to_python(std::move(args), signature);
         if (!o) throw python_error();
         return Variable(Object::from(PyObject_CallObject(function, o)));
@@ -232,7 +272,7 @@ struct PythonFunction {
 
 std::string get_type_name(TypeIndex idx) noexcept;
 
-std::string wrong_type_message(WrongType const &e, std::string_view={});
+std::string wrong_type_message(Mismatch const &e, std::string_view={});
 
 namespace runtime {
     char const * unknown_exception_description() noexcept;
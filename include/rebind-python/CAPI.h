@@ -43,6 +43,28 @@ struct Holder {
     T value; // I think stack is OK because this object is only casted to anyway.
 };
 
+/// Whether callable types are given a vectorcall entry point (PEP 590)
+#ifdef Py_TPFLAGS_HAVE_VECTORCALL
+#   define REBIND_VECTORCALL 1
+#else
+#   define REBIND_VECTORCALL 0
+#endif
+
+/// Holder of a callable type: when vectorcall is available, each instance stores the entry point of its type.
+/// Specialize Holder<T> to derive from it, and set entry when defining the type
+template <class T>
+struct CallableHolder {
+    static inline PyTypeObject type;
+#if REBIND_VECTORCALL
+    static inline vectorcallfunc entry = nullptr;
+#endif
+    PyObject_HEAD
+#if REBIND_VECTORCALL
+    vectorcallfunc vectorcall;
+#endif
+    T value;
+};
+
 template <class T>
 SubClass<PyTypeObject> type_object(Type<T> t={}) {return {&Holder<T>::type};}
 
@@ -68,6 +90,10 @@ PyObject *tp_new(PyTypeObject *subtype, PyObject *, PyObject *) noexcept {
     static_assert(noexcept(T{}), "Default constructor should be noexcept");
     PyObject *o = subtype->tp_alloc(subtype, 0); // 0 unused
     if (o) new (&cast_object<T>(o)) T; // Default construct the C++ type
+#if REBIND_VECTORCALL
+    if constexpr(std::is_base_of_v<CallableHolder<T>, Holder<T>>)
+        if (o) reinterpret_cast<Holder<T> *>(o)->vectorcall = Holder<T>::entry;
+#endif
     return o;
 }
 
@@ -146,6 +172,12 @@ PyTypeObject type_definition(char const *name, char const *doc) {
     o.tp_new = tp_new<T>;
     o.tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE;
     o.tp_doc = doc;
+#if REBIND_VECTORCALL
+    if constexpr(std::is_base_of_v<CallableHolder<T>, Holder<T>>) {
+        o.tp_vectorcall_offset = offsetof(Holder<T>, vectorcall);
+        o.tp_flags |= Py_TPFLAGS_HAVE_VECTORCALL;
+    }
+#endif
     return o;
 }
 
@@ -5,6 +5,7 @@
 
 #pragma once
 #include "CAPI.h"
+#include <rebind/Storage.h>
 
 namespace rebind {
 
@@ -52,6 +53,10 @@ struct Object {
     ~Object() {xdecref(ptr);}
 };
 
+/// Object is a single owning pointer, so a Variable may move it with memcpy
+template <>
+struct IsTriviallyRelocatable<Object> : std::true_type {};
+
 }
 
 namespace std {
@@ -77,6 +77,47 @@ std::is_convertible<T, C> has_head(Pack<R, T, Ts...>);
 
 /******************************************************************************/
 
+/// Outcome of an overload trial: mismatched arguments are reported without throwing
+enum class Trial : unsigned char {ok, wrong_number, wrong_type};
+
+inline Trial wrong_number(Dispatch &msg, unsigned int expected, unsigned int received) noexcept {
+    msg.expected = expected;
+    msg.received = received;
+    return Trial::wrong_number;
+}
+
+/// Result of requesting argument type T: a pointer for references, otherwise std::optional
+template <class T>
+using Requested = decltype(std::declval<Variable const &>().request(std::declval<Dispatch &>(), Type<T>()));
+
+/// Request argument i as T unless an earlier argument has failed
+template <class T>
+Requested<T> request_argument(bool &ok, Variable const &v, Dispatch &msg, std::size_t i) {
+    if (!ok) return {};
+    msg.index = i;
+    auto p = v.request(msg, Type<T>());
+    ok = bool(p);
+    return p;
+}
+
+template <class T, class H>
+T held_argument(H &h) {
+    if constexpr(std::is_reference_v<T>) return static_cast<T>(*h);
+    else return std::move(*h);
+}
+
+/// Convert the arguments in order, stopping at the first failure, and invoke the function if all succeeded
+template <class C, class F, class ...Ts, std::size_t ...Is>
+bool trial_invoke(Variable &out, C uses_caller, F const &f, Caller &&c, Sequence const &args, Dispatch &msg,
+                  Pack<Ts...>, std::index_sequence<Is...>) {
+    bool ok = true;
+    std::tuple<Requested<Ts>...> held{request_argument<Ts>(ok, args[Is], msg, Is)...};
+    if (ok) out = caller_invoke(uses_caller, f, std::move(c), held_argument<Ts>(std::get<Is>(held))...);
+    return ok;
+}
+
+/******************************************************************************/
+
 // N is the number of trailing optional arguments
 template <std::size_t N, class F, class SFINAE=void>
 struct Adapter {
@@ -84,35 +125,26 @@ struct Adapter {
     using UsesCaller = decltype(has_head<Caller>(SimpleSignature<F>()));
     using AllTypes = decltype(skip_head<1 + int(UsesCaller::value)>(SimpleSignature<F>()));
 
-    template <class P>
-    void call_one(P, Variable &out, Caller &&c, Dispatch &msg, Sequence &args) const {
-        P::indexed([&](auto ...ts) {
-            out = caller_invoke(UsesCaller(), function, std::move(c), cast_index(args, msg, simplify_argument(ts))...);
-        });
-    }
-
     template <std::size_t ...Is>
-    Variable call(Sequence &args, Caller &&c, Dispatch &msg, std::index_sequence<Is...>) const {
-        Variable out;
+    bool call(Variable &out, Sequence &args, Caller &&c, Dispatch &msg, std::index_sequence<Is...>) const {
+        bool ok = false;
         constexpr std::size_t const M = AllTypes::size - 1; // number of total arguments minus 1
         // check the number of arguments given and call with the under-specified arguments
-        ((args.size() == M - Is ? call_one(AllTypes::template slice<0, M - Is>(), out, std::move(c), msg, args) : void()), ...);
-        return out;
+        ((args.size() == M - Is ? void(ok = trial_invoke(out, UsesCaller(), function, std::move(c), args, msg,
+            AllTypes::template slice<0, M - Is>(), std::make_index_sequence<M - Is>())) : void()), ...);
+        return ok;
     }
 
-    Variable operator()(Caller c, Sequence args) const {
-        auto frame = c();
-        Caller handle(frame);
-        Dispatch msg(handle);
-        if (args.size() == AllTypes::size) // handle fully specified arguments
-            return AllTypes::indexed([&](auto ...ts) {
-                return caller_invoke(UsesCaller(), function, std::move(handle), cast_index(args, msg, simplify_argument(ts))...);
-            });
-        else if (args.size() < AllTypes::size - N)
-            throw WrongNumber(AllTypes::size - N, args.size());
+    Trial trial(Variable &out, Caller &c, Sequence &args, Dispatch &msg) const {
+        if (args.size() < AllTypes::size - N)
+            return wrong_number(msg, AllTypes::size - N, args.size());
         else if (args.size() > AllTypes::size)
-            throw WrongNumber(AllTypes::size, args.size()); // try under-specified arguments
-        return call(args, std::move(handle), msg, std::make_index_sequence<N>());
+            return wrong_number(msg, AllTypes::size, args.size());
+        msg.caller = c;
+        bool const ok = args.size() == AllTypes::size // handle fully specified arguments
+            ? trial_invoke(out, UsesCaller(), function, Caller(c), args, msg, AllTypes(), typename AllTypes::indices())
+            : call(out, args, Caller(c), msg, std::make_index_sequence<N>()); // try under-specified arguments
+        return ok ? Trial::ok : Trial::wrong_type;
     }
 };
 
@@ -124,16 +156,13 @@ struct Adapter<0, F, SFINAE> {
     using Ctx = decltype(has_head<Caller>(SimpleSignature<F>()));
     using Sig = decltype(skip_head<1 + int(Ctx::value)>(SimpleSignature<F>()));
 
-    Variable operator()(Caller c, Sequence args) const {
-        DUMP("Adapter<", type_index<F>(), ">::()");
+    Trial trial(Variable &out, Caller &c, Sequence &args, Dispatch &msg) const {
+        DUMP("Adapter<", type_index<F>(), ">::trial()");
         if (args.size() != Sig::size)
-            throw WrongNumber(Sig::size, args.size());
-        return Sig::indexed([&](auto ...ts) {
-            auto frame = c();
-            Caller handle(frame);
-            Dispatch msg(handle);
-            return caller_invoke(Ctx(), function, std::move(handle), cast_index(args, msg, ts)...);
-        });
+            return wrong_number(msg, Sig::size, args.size());
+        msg.caller = c;
+        bool const ok = trial_invoke(out, Ctx(), function, Caller(c), args, msg, Sig(), typename Sig::indices());
+        return ok ? Trial::ok : Trial::wrong_type;
     }
 };
 
@@ -143,35 +172,33 @@ template <class R, class C>
 struct Adapter<0, R C::*, std::enable_if_t<std::is_member_object_pointer_v<R C::*>>> {
     R C::* function;
 
-    Variable operator()(Caller c, Sequence args) const {
-        if (args.size() != 1) throw WrongNumber(1, args.size());
+    Trial trial(Variable &out, Caller &c, Sequence &args, Dispatch &msg) const {
+        if (args.size() != 1) return wrong_number(msg, 1, args.size());
         auto &s = args[0];
-        auto frame = c();
-        DUMP("Adapter<", type_index<R>(), ", ", type_index<C>(), ">::()");
-        Caller handle(frame);
-        Dispatch msg(handle);
+        DUMP("Adapter<", type_index<R>(), ", ", type_index<C>(), ">::trial()");
+        msg.caller = c;
 
         if (!s.type().matches<C>() || s.qualifier() == Lvalue) {
-            DUMP("Adapter<", type_index<R>(), ", ", type_index<C>(), ">::() try &");
+            DUMP("Adapter<", type_index<R>(), ", ", type_index<C>(), ">::trial() try &");
             if (auto p = s.request(msg, Type<C &>())) {
-                frame->enter();
-                return {Type<R &>(), std::invoke(function, *p)};
+                c.enter();
+                return out = {Type<R &>(), std::invoke(function, *p)}, Trial::ok;
             }
         }
 
-        DUMP("Adapter<", type_index<R>(), ", ", type_index<C>(), ">::() try const &");
+        DUMP("Adapter<", type_index<R>(), ", ", type_index<C>(), ">::trial() try const &");
         if (auto p = s.request(msg, Type<C const &>())) {
-            frame->enter();
-            return {Type<R const &>(), std::invoke(function, *p)};
+            c.enter();
+            return out = {Type<R const &>(), std::invoke(function, *p)}, Trial::ok;
         }
 
         if (auto p = s.request(msg, Type<C>())) {
-            DUMP("Adapter<", type_index<R>(), ", ", type_index<C>(), ">::() try &&");
-            frame->enter();
-            return {Type<std::remove_cv_t<R>>(), std::invoke(function, std::move(*p))};
+            DUMP("Adapter<", type_index<R>(), ", ", type_index<C>(), ">::trial() try &&");
+            c.enter();
+            return out = {Type<std::remove_cv_t<R>>(), std::invoke(function, std::move(*p))}, Trial::ok;
         }
 
-        throw std::move(msg).exception();
+        return Trial::wrong_type;
     }
 };
 
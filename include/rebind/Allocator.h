@@ -0,0 +1,152 @@
+/**
+ * @brief Allocation hook for heap held Variable payloads
+ * @file Allocator.h
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+/// Size in bytes of each chunk requested by an Arena
+#ifndef REBIND_ARENA_CHUNK
+#   define REBIND_ARENA_CHUNK 4096
+#endif
+
+namespace rebind {
+
+/******************************************************************************/
+
+/// Memory handed out by an Allocator: release(owner, memory) is called exactly once when it is freed
+struct Allocation {
+    void *memory = nullptr;
+    void (*release)(void *owner, void *memory) noexcept = nullptr;
+    void *owner = nullptr;
+};
+
+/// Interface for memory that heap held Variable payloads are placed into.
+/// Payloads may outlive the scope an Allocator is installed in, so each Allocation carries its own release.
+struct Allocator {
+    /// Return memory for n bytes aligned to a, or an empty Allocation to fall back to the global heap
+    virtual Allocation allocate(std::size_t n, std::size_t a) = 0;
+    virtual ~Allocator() {};
+};
+
+/// Counters of heap held Variable payloads created while an Allocator is installed; payloads made without one
+/// are not counted, so that the global heap path has no atomic operations
+struct AllocationCounters {
+    std::atomic<std::size_t> heap{0}; //< payloads placed on the global heap while an Allocator was installed
+    std::atomic<std::size_t> absorbed{0}; //< payloads placed by an installed Allocator
+    std::atomic<std::size_t> chunks{0}; //< chunks requested by Arena instances
+};
+
+extern AllocationCounters allocation_counters;
+
+/******************************************************************************/
+
+/// Return the Allocator installed on the current thread, or NULL
+Allocator *current_allocator() noexcept;
+
+/// RAII installation of an Allocator for the heap held payloads created on the current thread
+class AllocatorScope {
+    Allocator *previous;
+public:
+    explicit AllocatorScope(Allocator *a) noexcept;
+    ~AllocatorScope();
+    AllocatorScope(AllocatorScope const &) = delete;
+    AllocatorScope & operator=(AllocatorScope const &) = delete;
+};
+
+/******************************************************************************/
+
+/// Monotonic Allocator handing out memory from reference counted chunks.
+/// Destroying the Arena frees every chunk without a live payload in one shot;
+/// chunks still holding a payload (e.g. a returned value) are freed with their last payload.
+class Arena final : public Allocator {
+    struct Chunk;
+    Chunk *chunk = nullptr;
+    std::size_t size, offset = 0;
+public:
+    explicit Arena(std::size_t chunk_size=REBIND_ARENA_CHUNK) noexcept : size(chunk_size) {}
+    Arena(Arena const &) = delete;
+    Arena & operator=(Arena const &) = delete;
+
+    Allocation allocate(std::size_t n, std::size_t a) override;
+    ~Arena();
+};
+
+/******************************************************************************/
+
+/// Allocate memory for a heap held payload from the installed Allocator, preceded by a header recording its release.
+/// Return NULL if no Allocator is installed or it declined, in which case the global heap should be used
+void *allocate_placed(std::size_t n, std::size_t a);
+
+/// Free memory from allocate_placed(); a must be the same alignment
+void deallocate_placed(void *p, std::size_t a) noexcept;
+
+/// Allocate memory for a heap held payload from the global heap; it carries no header
+inline void *allocate_heap(std::size_t n, std::size_t a) {
+    if (a > __STDCPP_DEFAULT_NEW_ALIGNMENT__) return ::operator new(n, std::align_val_t(a));
+    return ::operator new(n);
+}
+
+/// Free memory from allocate_heap(); a must be the same alignment
+inline void deallocate_heap(void *p, std::size_t a) noexcept {
+    if (a > __STDCPP_DEFAULT_NEW_ALIGNMENT__) ::operator delete(p, std::align_val_t(a));
+    else ::operator delete(p);
+}
+
+/******************************************************************************/
+
+/// Reference count stored immediately before each shared heap held payload
+using SharedCount = std::atomic<std::size_t>;
+
+template <class T>
+constexpr std::size_t shared_offset = alignof(T) > sizeof(SharedCount) ? alignof(T) : sizeof(SharedCount);
+
+template <class T>
+constexpr std::size_t shared_alignment = alignof(T) > alignof(SharedCount) ? alignof(T) : alignof(SharedCount);
+
+inline SharedCount & shared_count(void *p) noexcept {
+    return *reinterpret_cast<SharedCount *>(static_cast<char *>(p) - sizeof(SharedCount));
+}
+
+/// Add an owner to a shared payload
+inline void acquire_shared(void *p) noexcept {shared_count(p).fetch_add(1, std::memory_order_relaxed);}
+
+/// Remove an owner from a shared payload and return if it was the last one
+inline bool release_shared(void *p) noexcept {return shared_count(p).fetch_sub(1, std::memory_order_acq_rel) == 1;}
+
+/******************************************************************************/
+
+/// Distance from the start of the memory of a payload to the object, which a shared payload precedes by its count
+template <class T, bool Shared>
+constexpr std::size_t payload_offset = Shared ? shared_offset<T> : 0;
+
+/// Size of the memory of a payload
+template <class T, bool Shared>
+constexpr std::size_t payload_size = payload_offset<T, Shared> + sizeof(T);
+
+/// Alignment of the memory of a payload
+template <class T, bool Shared>
+constexpr std::size_t payload_alignment = Shared ? shared_alignment<T> : alignof(T);
+
+/// Construct a payload (with a single owner if shared) in memory m, which is freed with free if the constructor throws
+template <class T, bool Shared, class ...Ts>
+T * construct_payload(void *m, void (*free)(void *, std::size_t) noexcept, Ts &&...ts) {
+    auto c = static_cast<char *>(m);
+    if constexpr(Shared) ::new(c + shared_offset<T> - sizeof(SharedCount)) SharedCount(1);
+    try {return ::new(c + payload_offset<T, Shared>) T(static_cast<Ts &&>(ts)...);}
+    catch (...) {free(m, payload_alignment<T, Shared>); throw;}
+}
+
+/// Destroy a payload and return the start of its memory
+template <class T, bool Shared>
+void * destroy_payload(T *t) noexcept {
+    t->~T();
+    return reinterpret_cast<char *>(t) - payload_offset<T, Shared>;
+}
+
+/******************************************************************************/
+
+}
@@ -3,6 +3,8 @@
 #include "Conversions.h"
 #include <cstdlib>
 #include <cstdint>
+#include <limits>
+#include <array>
 
 namespace rebind {
 
@@ -79,8 +81,30 @@ struct ArrayLayout {
         for (auto const &p : contents) out *= p.first;
         return out;
     }
+
+    /// Contiguous layout of the same shape, row-major unless fortran is set
+    ArrayLayout contiguous(bool fortran=false) const {
+        ArrayLayout out;
+        out.contents.resize(depth());
+        std::ptrdiff_t stride = 1;
+        for (std::size_t k = 0; k != depth(); ++k) {
+            auto const i = fortran ? k : depth() - 1 - k;
+            out.contents[i] = {shape(i), stride};
+            stride *= shape(i);
+        }
+        return out;
+    }
 };
 
+/// Copy the elements of an array with layout from into out with layout to, which has the same shape.
+/// Strides are in units of itemsize, which may be any number of bytes. Dimensions which are contiguous
+/// with each other are merged, and runs which are contiguous in both layouts are copied with memcpy
+void copy_array(void *out, ArrayLayout const &to, void const *data, ArrayLayout const &from, std::size_t itemsize);
+
+/// Copy the elements of an array with layout into contiguous out, row-major unless fortran is set,
+/// and return the layout of the copy (strides in units of itemsize)
+ArrayLayout copy_contiguous(void *out, void const *data, ArrayLayout const &layout, std::size_t itemsize, bool fortran=false);
+
 /******************************************************************************/
 
 /*
@@ -102,7 +126,7 @@ public:
 
     template <class T>
     ArrayData(T *t) : ArrayData(const_cast<std::remove_cv_t<T> *>(static_cast<T const *>(t)),
-                                &typeid(std::remove_cv_t<T>), std::is_const_v<T>) {}
+                                &typeid(std::remove_cv_t<T>), !std::is_const_v<T>) {}
 
     template <class T>
     T * target() const {
@@ -129,6 +153,128 @@ struct ArrayView {
 
 /******************************************************************************/
 
+/// ArrayView which keeps the memory it views alive until the last copy of it is destroyed.
+/// The owner is released by the deleter its producer supplied, e.g. one which takes the Python GIL
+struct SharedArray : ArrayView {
+    std::shared_ptr<void const> owner;
+
+    SharedArray() = default;
+    SharedArray(ArrayView v, std::shared_ptr<void const> o) noexcept : ArrayView(std::move(v)), owner(std::move(o)) {}
+};
+
+template <>
+struct Response<SharedArray> {
+    bool operator()(Variable &out, TypeIndex const &t, SharedArray const &a) const {
+        if (t.equals<ArrayView>()) return out.emplace(Type<ArrayView>(), a.data, a.layout), true;
+        return false;
+    }
+};
+
+/******************************************************************************/
+
+/// Whether array element conversions which may lose information (e.g. double to float) are allowed
+extern bool ArrayNarrowing;
+
+/// Result of converting an array of one built-in arithmetic type to another
+enum class ArrayConversion : unsigned char {ok, unsupported, narrowing, out_of_range};
+
+/// Convert the elements of type source with the given layout into contiguous row-major out of type dest.
+/// Conversions which may lose information are only made if narrow is set, and even then a value
+/// outside the range of an integral destination fails the conversion rather than wrapping around
+ArrayConversion convert_array(void *out, std::type_info const &dest, void const *data, std::type_info const &source,
+                              ArrayLayout const &layout, bool narrow);
+
+/******************************************************************************/
+
+/// Contiguous 1-dimensional array of T, bound to an ArrayView without copying.
+/// T must be const unless the array is writable. It is only valid while the viewed array is
+template <class T>
+class Span {
+    T *ptr = nullptr;
+    std::size_t n = 0;
+
+public:
+    Span() = default;
+    Span(T *p, std::size_t n) noexcept : ptr(p), n(n) {}
+
+    T * data() const noexcept {return ptr;}
+    std::size_t size() const noexcept {return n;}
+    bool empty() const noexcept {return n == 0;}
+
+    T * begin() const noexcept {return ptr;}
+    T * end() const noexcept {return ptr + n;}
+    T & operator[](std::size_t i) const noexcept {return ptr[i];}
+};
+
+/// N-dimensional array of T with strides in units of T, bound to an ArrayView without copying
+template <class T, std::size_t N>
+class StridedSpan {
+    T *ptr = nullptr;
+    std::array<std::size_t, N> shapes{};
+    std::array<std::ptrdiff_t, N> strides{};
+
+public:
+    StridedSpan() = default;
+    StridedSpan(T *p, std::array<std::size_t, N> const &shape, std::array<std::ptrdiff_t, N> const &stride) noexcept
+        : ptr(p), shapes(shape), strides(stride) {}
+
+    T * data() const noexcept {return ptr;}
+    std::size_t shape(std::size_t i) const noexcept {return shapes[i];}
+    std::ptrdiff_t stride(std::size_t i) const noexcept {return strides[i];}
+
+    /// Total number of elements
+    std::size_t size() const noexcept {
+        std::size_t out = 1;
+        for (auto s : shapes) out *= s;
+        return out;
+    }
+
+    template <class ...Is>
+    T & operator()(Is const ...is) const noexcept {
+        static_assert(sizeof...(Is) == N, "StridedSpan: wrong number of indices");
+        std::ptrdiff_t offset = 0, i = 0;
+        ((offset += static_cast<std::ptrdiff_t>(is) * strides[i++]), ...);
+        return ptr[offset];
+    }
+};
+
+/// Element pointer of an array of T, or an error explaining why it cannot be viewed as one
+template <class T>
+T * array_target(ArrayView const &a, Dispatch &msg, TypeIndex const &t) {
+    if (auto p = a.data.target<T>()) return p;
+    if (a.data.type() != typeid(std::remove_cv_t<T>)) return msg.error("array has the wrong element type", t), nullptr;
+    return msg.error("array is not writable", t), nullptr;
+}
+
+template <class T>
+struct Request<Span<T>> {
+    std::optional<Span<T>> operator()(Variable const &v, Dispatch &msg) const {
+        auto a = v.request<ArrayView>();
+        if (!a) return msg.error("expected array", typeid(Span<T>));
+        if (a->layout.depth() != 1) return msg.error("expected 1-dimensional array", typeid(Span<T>));
+        if (a->layout.shape(0) > 1 && a->layout.stride(0) != 1) return msg.error("expected contiguous array", typeid(Span<T>));
+        if (auto p = array_target<T>(*a, msg, typeid(Span<T>))) return Span<T>(p, a->layout.shape(0));
+        return msg.error();
+    }
+};
+
+template <class T, std::size_t N>
+struct Request<StridedSpan<T, N>> {
+    std::optional<StridedSpan<T, N>> operator()(Variable const &v, Dispatch &msg) const {
+        auto a = v.request<ArrayView>();
+        if (!a) return msg.error("expected array", typeid(StridedSpan<T, N>));
+        if (a->layout.depth() != N) return msg.error("array has the wrong number of dimensions", typeid(StridedSpan<T, N>),
+                             static_cast<int>(N), static_cast<int>(a->layout.depth()));
+        std::array<std::size_t, N> shape;
+        std::array<std::ptrdiff_t, N> stride;
+        for (std::size_t i = 0; i != N; ++i) shape[i] = a->layout.shape(i), stride[i] = a->layout.stride(i);
+        if (auto p = array_target<T>(*a, msg, typeid(StridedSpan<T, N>))) return StridedSpan<T, N>(p, shape, stride);
+        return msg.error();
+    }
+};
+
+/******************************************************************************/
+
 template <class T>
 struct Request<T *> {
     std::optional<T *> operator()(Variable const &v, Dispatch &msg) const {
@@ -242,6 +388,14 @@ struct Response<T, Value, std::enable_if_t<(std::is_floating_point_v<T>)>> {
     }
 };
 
+/// Whether integer i is representable as integral type T (bool accepts any value)
+template <class T>
+constexpr bool in_range(Integer i) noexcept {
+    if constexpr(std::is_same_v<T, bool>) return true;
+    else if constexpr(std::is_signed_v<T>) return i >= std::numeric_limits<T>::min() && i <= std::numeric_limits<T>::max();
+    else return i >= 0 && static_cast<std::make_unsigned_t<Integer>>(i) <= std::numeric_limits<T>::max();
+}
+
 /*
 Default Request for integer type tries to go through double precision
 long double is not expected to be a useful route (it's assumed there are not multiple floating types larger than Real)
@@ -257,13 +411,16 @@ struct Request<T, std::enable_if_t<std::is_floating_point_v<T>>> {
 
 
 /*
-Default Request for integer type tries to go through Integer
+Default Request for integer type tries to go through Integer, failing if the value is out of range
 */
 template <class T>
 struct Request<T, std::enable_if_t<std::is_integral_v<T>>> {
     std::optional<T> operator()(Variable const &v, Dispatch &msg) const {
         DUMP("trying convert to arithmetic", v.type(), typeid(T).name());
-        if (!std::is_same_v<Integer, T>) if (auto p = v.request<Integer>()) return static_cast<T>(*p);
+        if (!std::is_same_v<Integer, T>) if (auto p = v.request<Integer>()) {
+            if (in_range<T>(*p)) return static_cast<T>(*p);
+            return msg.error("integer out of range", typeid(T));
+        }
         DUMP("failed to convert to arithmetic", v.type(), typeid(T).name());
         return msg.error("not convertible to integer", typeid(T));
     }
@@ -501,14 +658,37 @@ struct VectorRequest {
     }
 
     std::optional<V> operator()(Variable const &v, Dispatch &msg) const {
+        bool narrowing = false;
         if (auto p = v.request<ArrayView>()) {
+            // an N-dimensional array is flattened in row-major order, whatever its strides
+            auto const &lay = p->layout;
+            std::size_t const n = lay.n_elem();
             if (auto t = p->data.target<T const>()) {
-                return V(t, t + p->layout.n_elem());
+                if (lay.row_major()) return V(t, t + n);
+                if constexpr(std::is_same_v<T, bool>) { // std::vector<bool> has no data()
+                    std::unique_ptr<bool[]> tmp(new bool[n]);
+                    copy_array(tmp.get(), lay.contiguous(), t, lay, sizeof(bool));
+                    return V(tmp.get(), tmp.get() + n);
+                } else if constexpr(std::is_trivially_copyable_v<T>) {
+                    V out(n);
+                    copy_array(out.data(), lay.contiguous(), t, lay, sizeof(T));
+                    return out;
+                } else return msg.error("expected contiguous array", typeid(V));
+            }
+            if constexpr(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+                V out(n);
+                switch (convert_array(out.data(), typeid(T), p->data.pointer(), p->data.type(), lay, ArrayNarrowing)) {
+                    case ArrayConversion::ok: return out;
+                    case ArrayConversion::out_of_range: return msg.error("array element out of range", typeid(V));
+                    case ArrayConversion::narrowing: narrowing = true; break; // converted element-wise below if possible
+                    case ArrayConversion::unsupported: break;
+                }
             }
         }
         // if (auto p = v.request<Vector<T>>()) return get(*p, msg);
         if (!std::is_same_v<V, Sequence>)
             if (auto p = v.request<Sequence>()) return get(*p, msg);
+        if (narrowing) return msg.error("array element conversion would narrow", typeid(V));
         return msg.error("expected sequence", typeid(V));
     }
 };
@@ -1,10 +1,12 @@
 #pragma once
 #include "Signature.h"
+#include <atomic>
 #include <cstdint>
 #include <vector>
 #include <iostream>
 #include <string_view>
 #include <memory>
+#include <algorithm>
 
 #ifdef NDEBUG
 #define DUMP(...) if (false) {}
@@ -82,35 +84,90 @@ Vector<T> mapped(V const &v, F &&f) {
 
 /******************************************************************************/
 
-/// Interface: return a new frame given a shared_ptr of *this
+/// Vector of trivially copyable T holding up to N elements without allocating
+template <class T, std::size_t N>
+class SmallVector {
+    static_assert(std::is_trivially_copyable_v<T>);
+    T local[N];
+    std::vector<T> heap; // holds all of the elements once there are more than N
+    std::size_t n = 0;
+public:
+    SmallVector() noexcept {}
+
+    T * begin() noexcept {return n > N ? heap.data() : local;}
+    T const * begin() const noexcept {return n > N ? heap.data() : local;}
+    T * end() noexcept {return begin() + n;}
+    T const * end() const noexcept {return begin() + n;}
+
+    std::size_t size() const noexcept {return n;}
+    bool empty() const noexcept {return !n;}
+    T & back() noexcept {return end()[-1];}
+    T & operator[](std::size_t i) noexcept {return begin()[i];}
+    T const & operator[](std::size_t i) const noexcept {return begin()[i];}
+
+    template <class ...Ts>
+    T & emplace_back(Ts &&...ts) {
+        if (n < N) local[n] = T(static_cast<Ts &&>(ts)...);
+        else {
+            if (n == N) heap.assign(local, local + N);
+            heap.emplace_back(static_cast<Ts &&>(ts)...);
+        }
+        ++n;
+        return back();
+    }
+
+    void pop_back() noexcept {
+        if (n > N) {
+            heap.pop_back();
+            if (n - 1 == N) std::copy(heap.begin(), heap.end(), local);
+        }
+        --n;
+    }
+
+    void clear() noexcept {heap.clear(); n = 0;}
+
+    operator Vector<T>() const {return Vector<T>(begin(), end());}
+};
+
+/******************************************************************************/
+
+/// Interface for the context that a Function is called from, identified without RTTI by its kind tag.
+/// Frames are recycled instead of freed: a Caller refers to a frame together with its generation,
+/// which is advanced whenever the frame is recycled, so stale Callers are seen as expired.
+/// The owner of a frame must keep it alive while the Callers referring to it are in use.
 struct Frame {
-    virtual std::shared_ptr<Frame> operator()(std::shared_ptr<Frame> &&) = 0;
+    void const *const kind; //< address of the tag of the derived type
+    std::atomic<std::uint64_t> generation{0}; //< 64 bits, so that it never wraps around to a stale Caller's
+
+    explicit Frame(void const *k) noexcept : kind(k) {}
+    Frame(Frame const &) = delete;
+    Frame & operator=(Frame const &) = delete;
+
     virtual void enter() {};
     virtual ~Frame() {};
 };
 
 /******************************************************************************/
 
+/// Non-owning reference to a Frame; cheap to copy
 class Caller {
-    std::weak_ptr<Frame> model;
+    Frame *frame = nullptr;
+    std::uint64_t generation = 0;
 public:
     Caller() = default;
 
-    explicit operator bool() const {return !model.expired();}
+    explicit Caller(Frame &f) noexcept : frame(&f), generation(f.generation.load(std::memory_order_relaxed)) {}
 
-    Caller(std::shared_ptr<Frame> const &f): model(f) {}
-
-    void enter() {if (auto p = model.lock()) p->enter();}
-
-    std::shared_ptr<Frame> operator()() const {
-        if (auto p = model.lock()) return p.get()->operator()(std::move(p));
-        return {};
+    explicit operator bool() const noexcept {
+        return frame && frame->generation.load(std::memory_order_acquire) == generation;
     }
 
+    void enter() {if (*this) frame->enter();}
+
+    /// Return the frame if it is still alive and of type T (identified by T::tag)
     template <class T>
-    T * target() {
-        if (auto p = model.lock()) return dynamic_cast<T *>(p.get());
-        return nullptr;
+    T * target() const noexcept {
+        return *this && frame->kind == &T::tag ? static_cast<T *>(frame) : nullptr;
     }
 };
 
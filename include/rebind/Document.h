@@ -57,12 +57,31 @@ struct Document {
         find_function(std::move(name)).emplace<N>(std::move(functor));
     }
 
+    /// Export function with named parameters, whose trailing defaults make the remaining ones optional
+    template <class F>
+    void function(std::string name, F functor, Vector<Parameter> parameters) {
+        render(typename Signature<F>::unqualified());
+        auto &f = find_function(std::move(name));
+        f.emplace<-1>(std::move(functor));
+        f.parameters = std::move(parameters);
+    }
+
     /// Always a function - no vagueness here
     template <int N=-1, class F, class ...Ts>
     void method(TypeIndex t, std::string name, F f) {
         Signature<F>::unqualified::for_each([&](auto r) {if (t != +r) render(+r);});
         find_method(t, std::move(name)).emplace<N>(std::move(f));
     }
+
+    /// Export method with named parameters, not including the instance (which is named "self")
+    template <class F>
+    void method(TypeIndex t, std::string name, F f, Vector<Parameter> parameters) {
+        Signature<F>::unqualified::for_each([&](auto r) {if (t != +r) render(+r);});
+        auto &m = find_method(t, std::move(name));
+        m.emplace<-1>(std::move(f));
+        parameters.emplace(parameters.begin(), "self");
+        m.parameters = std::move(parameters);
+    }
 };
 
 Document & document() noexcept;
@@ -8,7 +8,6 @@
 #include <algorithm>
 #include <string>
 #include <any>
-#include <deque>
 #include <optional>
 
 namespace rebind {
@@ -39,38 +38,83 @@ struct WrongNumber : DispatchError {
 
 /******************************************************************************/
 
-/// Exception for wrong type of an argument
-struct WrongType : DispatchError {
+/// Source of a failed conversion, described only when a message is needed:
+/// either a static string or a borrowed object with a function to describe it
+struct Description {
+    char const *name = nullptr;
+    void const *object = nullptr;
+    std::string (*describe)(void const *) = nullptr;
+
+    /// Demangled name of the std::type_info at p
+    static std::string type_name(void const *p) {return demangle(static_cast<std::type_info const *>(p)->name());}
+
+    /// Describe a type by its demangled name
+    static Description of(std::type_info const &t) noexcept {return {nullptr, &t, type_name};}
+
+    explicit operator bool() const noexcept {return name || describe;}
+    std::string str() const {return describe ? describe(object) : name ? name : "";}
+};
+
+/******************************************************************************/
+
+/// Diagnostics of a failed conversion, which own their text so that they may outlive the Dispatch.
+/// A source described by a function is still not described until the message is built
+struct Mismatch {
+    std::string scope = "mismatched type";
     std::vector<unsigned int> indices;
-    std::string source;
+    std::string source_name; // copy of Description::name, which is then cleared
+    Description source;
     TypeIndex dest;
-    int index, expected, received;
+    int index = -1, expected = -1, received = -1;
 
-    WrongType(std::string const &n, std::vector<unsigned int> &&v,
-              std::string &&s, TypeIndex &&d, int i, int e=0, int r=0) noexcept
-        : DispatchError(n), indices(std::move(v)), source(std::move(s)),
-          dest(std::move(d)), index(i), expected(e), received(r) {}
+    bool has_source() const noexcept {return source || !source_name.empty();}
+    std::string source_str() const {return source ? source.str() : source_name;}
+
+    /// Describe the source now, for a Mismatch which may outlive the object the description borrows.
+    /// A std::type_info outlives any Mismatch, so its description is left until the message is built
+    void describe_source() {if (source && source.describe != Description::type_name) source_name = source.str(), source = {};}
+};
+
+/// Exception for wrong type of an argument
+struct WrongType : DispatchError, Mismatch {
+    explicit WrongType(Mismatch m) : DispatchError(m.scope), Mismatch(std::move(m)) {}
 };
 
 /******************************************************************************/
 
+/// Destruction record of a temporary made during a conversion request
+struct Temporary {
+    void (*destroy)(void *) noexcept;
+    void *object;
+    Temporary *next;
+};
+
+/// Return memory from the per-thread arena of conversion temporaries; it is reclaimed when the outermost Dispatch ends
+void *allocate_temporary(std::size_t n, std::size_t a);
+
+/// Copy a string into the per-thread arena of conversion temporaries, adding a null terminator
+char const *copy_temporary(std::string_view s);
+
 struct Dispatch {
-    std::string scope;
+    char const *scope;
     Caller caller;
-    std::deque<std::any> storage; // deque is used so references don't go bad when doing emplace_back()
-    std::vector<unsigned int> indices;
-    std::string source;
+    Temporary *temporaries = nullptr; // most recently stored first
+    SmallVector<unsigned int, 8> indices;
+    Description source;
     TypeIndex dest;
     int index = -1, expected = -1, received = -1;
 
     std::nullopt_t error() noexcept {return std::nullopt;}
 
     /// Set error information and return std::nullopt for convenience
-    std::nullopt_t error(std::string msg) noexcept {
-        scope = std::move(msg);
+    std::nullopt_t error(char const *msg) noexcept {
+        scope = msg;
         return std::nullopt;
     }
 
+    /// Set error information and return std::nullopt for convenience; msg is copied
+    std::nullopt_t error(std::string_view msg) {return error(copy_temporary(msg));}
+
     /// Set error information and return std::nullopt for convenience
     std::nullopt_t error(TypeIndex d) noexcept {
         dest = std::move(d);
@@ -78,26 +122,40 @@ struct Dispatch {
     }
 
     /// Set error information and return std::nullopt for convenience
-    std::nullopt_t error(std::string msg, TypeIndex d, int e=-1, int r=-1) noexcept {
-        scope = std::move(msg);
+    std::nullopt_t error(char const *msg, TypeIndex d, int e=-1, int r=-1) noexcept {
+        scope = msg;
         dest = std::move(d);
         expected = e;
         received = r;
         return std::nullopt;
     }
 
-    /// Create exception from the current scopes and messages
-    WrongType exception() && noexcept {
-        return {std::move(scope), std::move(indices), std::move(source), std::move(dest), index, expected, received};
+    /// Summarize the current scopes and messages, copying the text which may live in the temporary arena
+    Mismatch mismatch() const {
+        Mismatch m{scope, {indices.begin(), indices.end()}, {}, source, dest, index, expected, received};
+        if (source.name) m.source_name = source.name, m.source.name = nullptr;
+        return m;
     }
 
+    /// Create exception from the current scopes and messages
+    WrongType exception() && {return WrongType(mismatch());}
+
     /// Store a value which will last the lifetime of a conversion request. Return its address
     template <class T>
     unqualified<T> * store(T &&t) {
-        return std::addressof(storage.emplace_back().emplace<unqualified<T>>(static_cast<T &&>(t)));
+        using U = unqualified<T>;
+        auto r = static_cast<Temporary *>(allocate_temporary(sizeof(Temporary), alignof(Temporary)));
+        auto p = ::new(allocate_temporary(sizeof(U), alignof(U))) U(static_cast<T &&>(t));
+        temporaries = ::new(r) Temporary{[](void *p) noexcept {static_cast<U *>(p)->~U();}, p, temporaries};
+        return p;
     }
 
-    Dispatch(Caller c={}, char const *s="mismatched type") : scope(s), caller(std::move(c)) {indices.reserve(8);}
+    bool has_temporaries() const noexcept {return temporaries;}
+
+    Dispatch(Caller c={}, char const *s="mismatched type") noexcept;
+    Dispatch(Dispatch const &) = delete;
+    Dispatch & operator=(Dispatch const &) = delete;
+    ~Dispatch();
 };
 
 /******************************************************************************/
@@ -7,7 +7,51 @@
 
 namespace rebind {
 
-using ErasedFunction = std::function<Variable(Caller, Sequence)>;
+/// Type-erased overload: either an Adapter, which reports mismatched arguments from trial(),
+/// or any callable Variable(Caller, Sequence), which is assumed to accept any arguments
+class ErasedFunction {
+    std::function<Trial(Variable &, Caller &, Sequence &, Dispatch &)> impl;
+
+    template <class F, class=void>
+    struct HasTrial : std::false_type {};
+
+    template <class F>
+    struct HasTrial<F, std::void_t<decltype(&F::trial)>> : std::true_type {};
+
+public:
+    ErasedFunction() = default;
+
+    template <class F, std::enable_if_t<!std::is_same_v<std::decay_t<F>, ErasedFunction>, int> = 0>
+    ErasedFunction(F f) {
+        if constexpr(HasTrial<F>::value) {
+            impl = [f=std::move(f)](Variable &out, Caller &c, Sequence &args, Dispatch &msg) {
+                return f.trial(out, c, args, msg);
+            };
+        } else {
+            impl = [f=std::move(f)](Variable &out, Caller &c, Sequence &args, Dispatch &) {
+                out = f(std::move(c), std::move(args));
+                return Trial::ok;
+            };
+        }
+    }
+
+    explicit operator bool() const {return bool(impl);}
+
+    /// Call with the given arguments; if they do not match, return the reason and leave the diagnostics in msg.
+    /// args are only modified if the call takes place
+    Trial trial(Variable &out, Caller &c, Sequence &args, Dispatch &msg) const {return impl(out, c, args, msg);}
+
+    /// Call with the given arguments, throwing WrongNumber or WrongType if they do not match
+    Variable operator()(Caller c, Sequence args) const {
+        Variable out;
+        Dispatch msg(c);
+        switch (impl(out, c, args, msg)) {
+            case Trial::ok: return out;
+            case Trial::wrong_number: throw WrongNumber(msg.expected, msg.received);
+            default: throw std::move(msg).exception();
+        }
+    }
+};
 
 template <class R, class ...Ts>
 static TypeIndex const signature_types[] = {typeid(R), typeid(Ts)...};
@@ -39,8 +83,70 @@ public:
 
 /******************************************************************************/
 
+/// Range of argument counts an overload accepts, and the exact type of its leading argument if known
+struct OverloadKey {
+    std::size_t min_args = 0, max_args = std::size_t(-1);
+    std::type_info const *leading = nullptr;
+};
+
+/// Number of successful calls of a Function after which its overloads are reordered by hit count (0 to disable)
+#ifndef REBIND_OVERLOAD_REORDER
+#   define REBIND_OVERLOAD_REORDER 4096
+#endif
+
+/// Candidate overloads of a Function for each number of arguments, rebuilt as overloads are registered.
+/// Within a number of arguments, overloads whose leading argument type is exactly that of the call come first;
+/// otherwise overloads which accepted more calls come first, then registration order.
+/// Hits are not synchronized: callers must serialize access (the Python module records them with the GIL held)
+class OverloadIndex {
+    struct Bucket {
+        Vector<unsigned int> all; //< overloads accepting this number of arguments
+        Zip<std::type_info const *, Vector<unsigned int>> leading; //< the same, reordered for each exact leading type
+    };
+    Vector<OverloadKey> keys;
+    Vector<std::size_t> hits; //< number of calls accepted by each overload
+    Vector<Bucket> buckets; //< buckets[n] for n arguments; the last also serves any larger number
+    std::size_t calls = 0;
+public:
+    void insert(OverloadKey const &k);
+
+    /// Rebuild the candidate orders from the current hit counts
+    void reorder();
+
+    /// Record that overload i accepted a call
+    void record(unsigned int i) {
+        ++hits[i];
+        if (REBIND_OVERLOAD_REORDER && ++calls % REBIND_OVERLOAD_REORDER == 0) reorder();
+    }
+
+    OverloadKey const & key(std::size_t i) const noexcept {return keys[i];}
+
+    /// Return the number of calls accepted by each overload, in registration order
+    Vector<std::size_t> const & counts() const noexcept {return hits;}
+
+    /// Return the indices of the overloads which may accept n arguments, the first of type leading.
+    /// The reference is invalidated by reorder(), which record() may call
+    Vector<unsigned int> const & candidates(std::size_t n, std::type_info const *leading) const noexcept;
+};
+
+/******************************************************************************/
+
+/// Named parameter of a Function, with an optional default value
+struct Parameter {
+    std::string name;
+    Variable value; //< default value, or empty if the argument is required
+
+    Parameter(char const *n) : name(n) {}
+    Parameter(std::string n, Variable v={}) : name(std::move(n)), value(std::move(v)) {}
+};
+
+/******************************************************************************/
+
 struct Function {
     Zip<ErasedSignature, ErasedFunction> overloads;
+    OverloadIndex index;
+    /// Names and defaults of the arguments, if declared, so that they may be bound by keyword
+    Vector<Parameter> parameters;
 
     Variable operator()(Caller c, Sequence v) const {
         DUMP("    - calling type erased Function ");
@@ -71,8 +177,9 @@ struct Function {
         return (*this)(std::move(c), std::move(v));
     }
 
-    Function & emplace(ErasedFunction f, ErasedSignature const &s) & {
+    Function & emplace(ErasedFunction f, ErasedSignature const &s, OverloadKey const &k={}) & {
         overloads.emplace_back(s, std::move(f));
+        index.insert(k);
         return *this;
     }
 
@@ -81,9 +188,13 @@ struct Function {
     template <int N = -1, class F>
     Function & emplace(F f) & {
         auto fun = SimplifyFunction<F>()(std::move(f));
-        constexpr std::size_t n = N == -1 ? 0 : SimpleSignature<decltype(fun)>::size - 1 - N;
-        overloads.emplace_back(SimpleSignature<decltype(fun)>(), Adapter<n, decltype(fun)>{std::move(fun)});
-        return *this;
+        using Sig = SimpleSignature<decltype(fun)>;
+        constexpr std::size_t n = N == -1 ? 0 : Sig::size - 1 - N;
+        // number of arguments: skip the return type and a leading Caller
+        constexpr std::size_t m = Sig::size - 1 - decltype(has_head<Caller>(Sig()))::value;
+        OverloadKey k{m - n, m, nullptr};
+        if constexpr(m > 0) k.leading = &typeid(typename decltype(Sig::template at<Sig::size - m>())::type);
+        return emplace(Adapter<n, decltype(fun)>{std::move(fun)}, Sig(), k);
     }
 };
 
@@ -1,6 +1,7 @@
 #pragma once
 #include "Common.h"
 #include "Error.h"
+#include "Allocator.h"
 
 namespace rebind {
 
@@ -8,8 +9,22 @@ namespace rebind {
 
 struct Dispatch;
 struct VariableData;
+class Variable;
 
-using Storage = std::aligned_storage_t<4 * sizeof(void*), std::alignment_of_v<void *>>;
+/// Inline capacity in bytes of a Variable; it must be able to hold at least a pointer
+#ifndef REBIND_VARIABLE_CAPACITY
+#   define REBIND_VARIABLE_CAPACITY (4 * sizeof(void *))
+#endif
+
+/// Alignment of the inline buffer of a Variable; raise it to hold over-aligned types on the stack
+#ifndef REBIND_VARIABLE_ALIGNMENT
+#   define REBIND_VARIABLE_ALIGNMENT alignof(void *)
+#endif
+
+using Storage = std::aligned_storage_t<REBIND_VARIABLE_CAPACITY, REBIND_VARIABLE_ALIGNMENT>;
+
+static_assert(sizeof(Storage) >= sizeof(void *), "Variable capacity must hold a pointer");
+static_assert(alignof(Storage) >= alignof(void *), "Variable alignment must be at least that of a pointer");
 
 template <class T, class=void>
 struct UseStack : std::integral_constant<bool, (sizeof(T) <= sizeof(Storage))
@@ -18,10 +33,23 @@ struct UseStack : std::integral_constant<bool, (sizeof(T) <= sizeof(Storage))
     static_assert(std::is_same_v<T, std::decay_t<T>>);
 };
 
-/******************************************************************************/
+/// Whether heap held values of T are shared between copies of a Variable, being copied only when mutable access is requested.
+/// Specialize to std::true_type for large types which are often passed along without modification
+template <class T, class=void>
+struct UseShared : std::false_type {};
+
+/// Whether conversion routes from a held T may be cached by type alone (see Route).
+/// Specialize to std::true_type for types whose Response never depends on the held value
+template <class T, class=void>
+struct UseRouteCache : std::integral_constant<bool, std::is_arithmetic_v<T> || std::is_enum_v<T>
+    || std::is_same_v<T, std::nullptr_t>> {};
 
-enum class ActionType : std::uint_fast8_t {destroy, copy, move, response, assign};
-using ActionFunction = void(*)(ActionType, void *, VariableData *);
+/// Whether moving a T and then forgetting the source is equivalent to copying its bytes.
+/// Specialize to std::true_type for types holding no pointers into themselves (e.g. a reference-counted handle)
+template <class T, class=void>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+/******************************************************************************/
 
 struct RequestData {
     TypeIndex type;
@@ -29,57 +57,126 @@ struct RequestData {
     Qualifier source;
 };
 
-static_assert(UseStack<RequestData>::value);
 static_assert(std::is_trivially_destructible_v<RequestData>);
 
-// destroy: delete the value stored at (void *)
-// copy: copy value from (void *) into empty (Variable *)
-// move: move value from (void *) into empty (Variable *)
-// assign: assign existing value at (void *) = existing value in (Variable *)
-// response: convert existing value in (void *) to new value in (Variable *)
-//           using RequestData pre-stored in Variable->storage
+/// Per-type table of the operations on a held (non-reference) object
+struct ActionTable {
+    /// Delete the value stored at (void *)
+    void (*destroy)(void *) noexcept;
+    /// Copy value from (void const *) into the empty buffer of (VariableData &)
+    void (*copy)(VariableData &, void const *);
+    /// Move value from (void *) into the empty buffer of (VariableData &); noexcept for stack types
+    void (*move)(VariableData &, void *);
+    /// Convert existing value in (void *) to a new value in (Variable &) as specified by (RequestData)
+    void (*response)(Variable &, void *, RequestData const &);
+    /// Assign existing value at (void *) = existing value in (Variable &), resetting it on success
+    void (*assign)(void *, Variable &);
+    /// Stack held values may be copied with memcpy
+    bool trivially_copyable;
+    /// Stack held values need no destructor call
+    bool trivially_destructible;
+    /// Stack held values may be moved with memcpy and then forgotten
+    bool trivially_relocatable;
+    /// Heap held values are reference counted and shared between copies
+    bool shared;
+    /// Conversion routes from the held type are cached
+    bool cache_routes;
+};
 
 /******************************************************************************/
 
-// static_assert(sizeof(std::type_info const *) == sizeof(TypeIndex));
-// static_assert(alignof(std::type_info const *) == alignof(TypeIndex));
+static_assert(alignof(std::type_info) >= 8, "the low 3 bits of std::type_info pointers are used as flags");
 
+/// Layout: the inline buffer, the action, and a header word packing the held
+/// std::type_info pointer with its Qualifier (bits 0-1) and stack flag (bit 2)
 struct VariableData {
     Storage buff; //< Buffer holding either pointer to the object, or the object itself
-    ActionFunction act; //< Action<T>::apply of the held object, or NULL
-    TypeIndex idx; //< type and qualifier of the held object, or NULL
-    bool stack; //< Whether the held type (non-reference) can fit in the buffer
+    ActionTable const *act; //< Action<T>::table (or placed_table) of the held object, or NULL
+    std::uintptr_t header; //< type, qualifier and stack flag of the held object, or 0
 
-    constexpr VariableData() noexcept : buff(), act(nullptr), stack(false) {}
+    static constexpr std::uintptr_t QualifierMask = 0x3, StackMask = 0x4, InfoMask = ~std::uintptr_t(0x7);
 
-    VariableData(TypeIndex i, ActionFunction a, bool s) noexcept : buff(), act(a), idx(i), stack(s) {}
+    static std::uintptr_t make_header(TypeIndex const &i, bool s) noexcept {
+        return i ? reinterpret_cast<std::uintptr_t>(&i.info()) | (s ? StackMask : 0) | i.qualifier() : 0;
+    }
+
+    constexpr VariableData() noexcept : buff(), act(nullptr), header(0) {}
+
+    VariableData(TypeIndex i, ActionTable const *a, bool s) noexcept : buff(), act(a), header(make_header(i, s)) {}
 
     void reset_data() noexcept {
         if (!act) return;
         buff = Storage();
-        idx = {};
         act = nullptr;
-        stack = false;
+        header = 0;
+    }
+
+    /// Return the held std::type_info or NULL
+    std::type_info const *info() const noexcept {return reinterpret_cast<std::type_info const *>(header & InfoMask);}
+
+    Qualifier qualifier() const noexcept {return static_cast<Qualifier>(header & QualifierMask);}
+
+    void set_qualifier(Qualifier q) noexcept {header = (header & ~QualifierMask) | q;}
+
+    /// Whether the held type (non-reference) can fit in the buffer
+    bool stack() const noexcept {return header & StackMask;}
+
+    /// Return the type and qualifier of the held object
+    TypeIndex index() const noexcept {
+        if (auto i = info()) return {*i, qualifier()};
+        return {};
+    }
+
+    void set_index(TypeIndex const &i, bool s) noexcept {header = make_header(i, s);}
+
+    template <class T>
+    bool matches(Type<T> t={}) const noexcept {auto i = info(); return i && typeid(T) == *i;}
+
+    bool matches(TypeIndex const &t) const noexcept {return t ? info() == &t.info() : !info();}
+
+    /// Destroy the held object if it is being managed; the data is left unchanged
+    void destroy() noexcept {
+        if (auto p = handle()) {
+            if (stack()) {if (!act->trivially_destructible) act->destroy(p);}
+            else if (!act->shared || release_shared(p)) act->destroy(p);
+        }
+    }
+
+    /// Copy the managed object at p, which the buffer already holds a bytewise copy of
+    void copy_from(void *p) {
+        if (stack()) {if (!act->trivially_copyable) act->copy(*this, p);}
+        else if (act->shared) acquire_shared(p);
+        else act->copy(*this, p);
+    }
+
+    /// Make a private copy of a shared heap held object before it is mutated
+    void unshare() {
+        auto p = handle();
+        if (p && !stack() && act->shared && shared_count(p).load(std::memory_order_acquire) != 1) {
+            auto const old = act; // the copy may be placed differently, changing the table
+            act->copy(*this, p);
+            if (release_shared(p)) old->destroy(p);
+        }
     }
 
     /// Return a pointer to the held object if it exists
     void * pointer() const noexcept {
         if (!act) return nullptr;
-        else if (idx.qualifier() == Value && stack) return &const_cast<Storage &>(buff);
+        else if (qualifier() == Value && stack()) return &const_cast<Storage &>(buff);
         else return reinterpret_cast<void * const &>(buff);
     }
 
     /// Return a pointer to the held object if it exists and is being managed
     void * handle() const noexcept {
-        if (!act || idx.qualifier() != Value) return nullptr;
-        else if (stack) return &const_cast<Storage &>(buff);
+        if (!act || qualifier() != Value) return nullptr;
+        else if (stack()) return &const_cast<Storage &>(buff);
         else return reinterpret_cast<void * const &>(buff);
     }
 
     template <class T, std::enable_if_t<std::is_reference_v<T>, int> = 0>
     std::remove_reference_t<T> *target_pointer(Type<T> t, Qualifier q) const noexcept {
         // Qualifier is assumed not to be V
-        return (idx.matches<T>()) && (
+        return (matches<T>()) && (
             (std::is_const_v<std::remove_reference_t<T>>)
             || (std::is_rvalue_reference_v<T> && q == Rvalue)
             || (std::is_lvalue_reference_v<T> && (q == Lvalue))
@@ -5,6 +5,7 @@
 
 #pragma once
 #include "Storage.h"
+#include "Allocator.h"
 #include "Signature.h"
 
 #include <iostream>
@@ -31,27 +32,50 @@ struct Action;
 
 /******************************************************************************/
 
+/// Which conversion succeeded for a given held type, requested type, and source qualifier.
+/// Failures are not recorded, since a Request may reject one value and accept another
+enum class Route : unsigned char {unknown, response, request};
+
+/// Look up a route in the process-wide cache
+Route find_route(std::type_info const &held, TypeIndex const &t, Qualifier source) noexcept;
+
+/// Record a route in the process-wide cache
+void store_route(std::type_info const &held, TypeIndex const &t, Qualifier source, Route r);
+
+/******************************************************************************/
+
 class Variable : protected VariableData {
-    Variable(void *p, TypeIndex idx, ActionFunction act, bool s) noexcept
+    Variable(void *p, TypeIndex idx, ActionTable const *act, bool s) noexcept
         : VariableData(p ? idx : TypeIndex(), p ? act : nullptr, p && s)
         {if (p) reinterpret_cast<void *&>(buff) = p;}
 
+    /// A held shared payload gains an owner; the target of a reference is copied, since it may not be a counted payload
     Variable(Variable const &v, bool move) : VariableData(v) {
-        if (v.has_value())
-            act(move ? ActionType::move : ActionType::copy, v.pointer(), this);
-        idx.set_qualifier(Value);
+        if (auto p = v.handle(); p && !stack() && act->shared) acquire_shared(p);
+        else if (v.has_value())
+            move && !act->shared ? act->move(*this, v.pointer()) : act->copy(*this, v.pointer());
+        set_qualifier(Value);
     }
 
     Variable request_var(Dispatch &msg, TypeIndex const &, Qualifier source) const;
 
+    /// Cached route to t, or Route::unknown if the held type does not use the route cache
+    Route route(TypeIndex const &t) const noexcept {
+        return act && act->cache_routes ? find_route(*info(), t, qualifier()) : Route::unknown;
+    }
+
+    void set_route(TypeIndex const &t, Route r) const {
+        if (act && act->cache_routes) store_route(*info(), t, qualifier(), r);
+    }
+
 public:
 
-    Qualifier qualifier() const {return idx.qualifier();}
+    Qualifier qualifier() const {return VariableData::qualifier();}
     void const * data() const {return pointer();}
 
-    TypeIndex type() const {return idx;}
-    ActionFunction action() const {return act;}
-    bool is_stack_type() const {return stack;}
+    TypeIndex type() const {return index();}
+    ActionTable const * action() const {return act;}
+    bool is_stack_type() const {return stack();}
 
     /**************************************************************************/
 
@@ -60,32 +84,32 @@ public:
     /// Reference type
     template <class T, std::enable_if_t<!(std::is_same_v<std::decay_t<T>, T>), int> = 0>
     Variable(Type<T> t, typename SameType<T>::type reference) noexcept
-        : VariableData(t, Action<std::decay_t<T>>::apply, UseStack<unqualified<T>>::value) {
+        : VariableData(t, &Action<std::decay_t<T>>::table, UseStack<unqualified<T>>::value) {
             reinterpret_cast<std::remove_reference_t<T> *&>(buff) = std::addressof(reference);
         }
 
     /// Non-Reference type
     template <class T, class ...Ts, std::enable_if_t<(std::is_same_v<std::decay_t<T>, T>), int> = 0>
-    Variable(Type<T> t, Ts &&...ts) : VariableData(t, Action<T>::apply, UseStack<T>::value) {
+    Variable(Type<T> t, Ts &&...ts) : VariableData(t, &Action<T>::table, UseStack<T>::value) {
         static_assert(!std::is_same_v<unqualified<T>, Variable>);
         if constexpr(UseStack<T>::value) ::new (&buff) T(static_cast<Ts &&>(ts)...);
-        else reinterpret_cast<T *&>(buff) = ::new T(static_cast<Ts &&>(ts)...);
+        else Action<T>::allocate(*this, static_cast<Ts &&>(ts)...);
     }
 
     template <class T, std::enable_if_t<!(std::is_same_v<std::decay_t<T>, T>), int> = 0>
     std::remove_reference_t<T> *emplace(Type<T> t, typename SameType<T>::type reference) {
         using U = unqualified<T>;
-        if (auto p = handle()) act(ActionType::destroy, p, nullptr);
-        static_cast<VariableData &>(*this) = {t, Action<U>::apply, UseStack<U>::value};
+        destroy();
+        static_cast<VariableData &>(*this) = {t, &Action<U>::table, UseStack<U>::value};
         return reinterpret_cast<std::remove_reference_t<T> *&>(buff) = std::addressof(reference);
     }
 
     template <class T, class ...Ts, std::enable_if_t<(std::is_same_v<T, std::decay_t<T>>), int> = 0>
     T * emplace(Type<T> t, Ts &&...ts) {
-        if (auto p = handle()) act(ActionType::destroy, p, nullptr);
-        static_cast<VariableData &>(*this) = {t, Action<T>::apply, UseStack<T>::value};
+        destroy();
+        static_cast<VariableData &>(*this) = {t, &Action<T>::table, UseStack<T>::value};
         if constexpr(UseStack<T>::value) return ::new (&buff) T(static_cast<Ts &&>(ts)...);
-        else return reinterpret_cast<T *&>(buff) = ::new T(static_cast<Ts &&>(ts)...);
+        else return Action<T>::allocate(*this, static_cast<Ts &&>(ts)...);
     }
 
     template <class T, std::enable_if_t<!std::is_base_of_v<VariableData, unqualified<T>>, int> = 0>
@@ -96,17 +120,17 @@ public:
     /// Take variables and reset the old ones
     // If RHS is Reference, RHS is left unchanged
     // If RHS is Value and held in stack, RHS is moved from
-    // If RHS is Value and not held in stack, RHS is reset
+    // If RHS is Value and not held in stack or trivially relocatable, RHS is reset
     Variable(Variable &&v) noexcept : VariableData(static_cast<VariableData const &>(v)) {
         if (auto p = v.handle()) {
-            if (stack) act(ActionType::move, p, this);
-            else v.reset_data();
+            if (!stack() || act->trivially_relocatable) v.reset_data();
+            else act->move(*this, p);
         }
     }
 
-    /// Only call variable copy constructor if its lifetime is being managed
+    /// Only call variable copy constructor if its lifetime is being managed (and it is not a trivial copy or shared)
     Variable(Variable const &v) : VariableData(static_cast<VariableData const &>(v)) {
-        if (auto p = v.handle()) act(ActionType::copy, p, this);
+        if (auto p = v.handle()) copy_from(p);
     }
 
     template <class T, std::enable_if_t<!std::is_base_of_v<VariableData, unqualified<T>>, int> = 0>
@@ -115,29 +139,29 @@ public:
     /// Only call variable move constructor if its lifetime is being managed inside the buffer
     Variable & operator=(Variable &&v) noexcept {
         // DUMP("move assign ", type(), v.type());
-        if (auto p = handle()) act(ActionType::destroy, p, nullptr);
+        destroy();
         static_cast<VariableData &>(*this) = v;
         if (auto p = v.handle()) {
-            if (stack) act(ActionType::move, p, this);
-            else v.reset_data();
+            if (!stack() || act->trivially_relocatable) v.reset_data();
+            else act->move(*this, p);
         }
         return *this;
     }
 
     Variable & operator=(Variable const &v) {
         // DUMP("copy assign ", type(), v.type());
-        if (auto p = handle()) act(ActionType::destroy, p, nullptr);
+        destroy();
         static_cast<VariableData &>(*this) = v;
-        if (auto p = v.handle()) v.act(ActionType::copy, p, this);
+        if (auto p = v.handle()) copy_from(p);
         return *this;
     }
 
     ~Variable() {
-        if (auto p = handle()) {
-            DUMP("Variable::~Variable() deallocate ", qualifier(), " from variable ", idx);
-            act(ActionType::destroy, p, nullptr);
+        if (handle()) {
+            DUMP("Variable::~Variable() deallocate ", qualifier(), " from variable ", type());
+            destroy();
         } else {
-            DUMP("Variable::~Variable() not deleting ", qualifier(), " from variable ", idx);
+            DUMP("Variable::~Variable() not deleting ", qualifier(), " from variable ", type());
         }
     }
 
@@ -145,8 +169,7 @@ public:
 
     void reset() {
         // DUMP("reset", type());
-
-        if (auto p = handle()) act(ActionType::destroy, p, nullptr);
+        destroy();
         reset_data();
     }
 
@@ -160,33 +183,39 @@ public:
     Variable copy() && {return {*this, qualifier() == Value || qualifier() == Rvalue};}
     Variable copy() const & {return {*this, qualifier() == Rvalue};}
 
-    Variable reference() & {return {pointer(), idx.add(Lvalue), act, stack};}
-    Variable reference() const & {return {pointer(), idx.add(Const), act, stack};}
-    Variable reference() && {return {pointer(), idx.add(Rvalue), act, stack};}
+    // Mutable access to a shared payload first makes a private copy of it
+    Variable reference() & {unshare(); return {pointer(), index().add(Lvalue), act, stack()};}
+    Variable reference() const & {return {pointer(), index().add(Const), act, stack()};}
+    Variable reference() && {unshare(); return {pointer(), index().add(Rvalue), act, stack()};}
 
     Variable request_variable(Dispatch &msg, TypeIndex const &t) const & {return request_var(msg, t, add(qualifier(), Const));}
-    Variable request_variable(Dispatch &msg, TypeIndex const &t) & {return request_var(msg, t, add(qualifier(), Lvalue));}
-    Variable request_variable(Dispatch &msg, TypeIndex const &t) && {return request_var(msg, t, add(qualifier(), Rvalue));}
+    Variable request_variable(Dispatch &msg, TypeIndex const &t) & {unshare(); return request_var(msg, t, add(qualifier(), Lvalue));}
+    Variable request_variable(Dispatch &msg, TypeIndex const &t) && {unshare(); return request_var(msg, t, add(qualifier(), Rvalue));}
 
-    bool move_if_lvalue() {return idx.qualifier() == Lvalue ? idx.set_qualifier(Rvalue), true : false;}
+    bool move_if_lvalue() {return qualifier() == Lvalue ? set_qualifier(Rvalue), true : false;}
 
     /**************************************************************************/
 
     // request reference T by custom conversions
     template <class T, std::enable_if_t<std::is_reference_v<T>, int> = 0>
     std::remove_reference_t<T> *request(Dispatch &msg, Type<T> t={}) const {
-        DUMP("Variable.request() ", typeid(Type<T>).name(), qualifier(), " from variable ", idx);
-        DUMP("Variable.request(): trivial = ", idx.matches<T>());
-        if (idx.matches<T>()) return target<T>();
-        auto v = request_variable(msg, type_index<T>());
-        if (auto p = v.template target<T>()) {
-            DUMP("Variable.request():succeeded");
-            msg.source.clear(); 
-            return p;
+        DUMP("Variable.request() ", typeid(Type<T>).name(), qualifier(), " from variable ", type());
+        DUMP("Variable.request(): trivial = ", matches<T>());
+        if (matches<T>()) return target<T>();
+        auto const r = route(type_index<T>());
+        if (r != Route::request) {
+            auto v = request_variable(msg, type_index<T>());
+            if (auto p = v.template target<T>()) {
+                DUMP("Variable.request():succeeded");
+                if (r == Route::unknown) set_route(type_index<T>(), Route::response);
+                msg.source = {}; 
+                return p;
+            }
         }
         if (auto p = Request<T>()(*this, msg)) {
             DUMP("Variable.request(): succeeded via custom Request");
-            msg.source.clear(); 
+            if (r == Route::unknown) set_route(type_index<T>(), Route::request);
+            msg.source = {}; 
             return p;
         }
         DUMP("Variable.request(): failed");
@@ -203,9 +232,19 @@ public:
             if (auto p = target<T const &>()) out.emplace(*p);
         } 
 	if (!out) {
-            auto v = request_variable(msg, typeid(T));
-            if (auto p = std::move(v).target<T &&>()) {msg.source.clear(); out.emplace(std::move(*p));}
-            else if ((out = Request<T>()(*this, msg))) msg.source.clear();
+            auto const r = route(typeid(T));
+            if (r != Route::request) {
+                auto v = request_variable(msg, typeid(T));
+                if (auto p = std::move(v).target<T &&>()) {
+                    if (r == Route::unknown) set_route(typeid(T), Route::response);
+                    msg.source = {};
+                    return out.emplace(std::move(*p)), out;
+                }
+            }
+            if ((out = Request<T>()(*this, msg))) {
+                if (r == Route::unknown) set_route(typeid(T), Route::request);
+                msg.source = {};
+            }
         }
         // DUMP(type(), p, &buff, reinterpret_cast<void * const &>(buff), stack, typeid(p).name(), typeid(Type<T>).name());
 
@@ -233,13 +272,14 @@ public:
     T cast(Type<T> t={}) const {
         Dispatch msg;
         if (auto p = request(msg, t))
-            return msg.storage.empty() ? static_cast<T>(*p) : throw std::runtime_error("contains temporaries");
+            return !msg.has_temporaries() ? static_cast<T>(*p) : throw std::runtime_error("contains temporaries");
         return cast(msg, t);
     }
 
     template <class T, std::enable_if_t<std::is_reference_v<T>, int> = 0>
     std::remove_reference_t<T> *target(Type<T> t={}) && {
         // DUMP(name(), typeid(Type<T>).name(), qual, stack);
+        if constexpr(!std::is_const_v<std::remove_reference_t<T>>) unshare();
         return target_pointer(t, add(qualifier(), Rvalue));
     }
 
@@ -254,6 +294,7 @@ public:
     template <class T, std::enable_if_t<std::is_reference_v<T>, int> = 0>
     std::remove_reference_t<T> *target(Type<T> t={}) & {
         // DUMP(name(), typeid(Type<T>).name(), qual, stack);
+        if constexpr(!std::is_const_v<std::remove_reference_t<T>>) unshare();
         return target_pointer(t, add(qualifier(), Lvalue));
     }
 };
@@ -309,54 +350,86 @@ template <class T>
 struct Action {
     static_assert(std::is_same_v<unqualified<T>, T>);
 
-    static void response(Variable &v, void *p, RequestData &&r) {
+    static constexpr bool Shared = UseShared<T>::value && !UseStack<T>::value;
+
+    /// Allocate a heap held object into the buffer of v, in memory from the installed Allocator if it accepts it.
+    /// Such an object is held with placed_table, whose destroy frees it through the Allocator
+    template <class ...Ts>
+    static T * allocate(VariableData &v, Ts &&...ts) {
+        constexpr auto n = payload_size<T, Shared>, a = payload_alignment<T, Shared>;
+        T *t;
+        if (void *m = allocate_placed(n, a)) {
+            t = construct_payload<T, Shared>(m, deallocate_placed, static_cast<Ts &&>(ts)...);
+            v.act = &placed_table;
+        } else {
+            t = construct_payload<T, Shared>(allocate_heap(n, a), deallocate_heap, static_cast<Ts &&>(ts)...);
+            v.act = &table;
+        }
+        return reinterpret_cast<T *&>(v.buff) = t;
+    }
+
+    static void destroy(void *p) noexcept {
+        DUMP("delete ", typeid(T).name());
+        if constexpr(UseStack<T>::value) static_cast<T *>(p)->~T();
+        else deallocate_heap(destroy_payload<T, Shared>(static_cast<T *>(p)), payload_alignment<T, Shared>);
+    }
+
+    static void destroy_placed(void *p) noexcept {
+        DUMP("delete placed ", typeid(T).name());
+        deallocate_placed(destroy_payload<T, Shared>(static_cast<T *>(p)), payload_alignment<T, Shared>);
+    }
+
+    /// Copy-Construct the object
+    static void copy(VariableData &v, void const *p) {
+        DUMP(v.stack(), UseStack<T>::value);
+        if constexpr(std::is_copy_constructible_v<T>) {
+            if constexpr(UseStack<T>::value) ::new(static_cast<void *>(&v.buff)) T(*static_cast<T const *>(p));
+            else allocate(v, *static_cast<T const *>(p));
+        } else throw std::invalid_argument("not copyable");
+    }
+
+    /// Move-Construct the object
+    static void move(VariableData &v, void *p) {
+        DUMP(v.stack(), UseStack<T>::value);
+        if constexpr(UseStack<T>::value) ::new(static_cast<void *>(&v.buff)) T(std::move(*static_cast<T *>(p)));
+        else if constexpr(std::is_move_constructible_v<T>) allocate(v, std::move(*static_cast<T *>(p)));
+        else copy(v, p);
+    }
+
+    /// Respond to a given type_index
+    static void response(Variable &v, void *p, RequestData const &r) {
+        DUMP("response", typeid(T).name());
         bool ok = false;
-        Dispatch &msg = *r.msg; // r is aliasing v, so save a copy of the reference
         if (r.source == Const)
-            ok = get_response(v, std::move(r.type), *static_cast<T const *>(p));
+            ok = get_response(v, r.type, *static_cast<T const *>(p));
         else if (r.source == Lvalue)
-            ok = get_response(v, std::move(r.type), *static_cast<T *>(p));
+            ok = get_response(v, r.type, *static_cast<T *>(p));
         else if (r.source == Rvalue)
-            ok = get_response(v, std::move(r.type), static_cast<T &&>(*static_cast<T *>(p)));
+            ok = get_response(v, r.type, static_cast<T &&>(*static_cast<T *>(p)));
         else throw std::invalid_argument("source qualifier should not be Value");
         if (!ok) {
-            set_source(msg, typeid(T), std::move(v)); v.reset();
+            set_source(*r.msg, typeid(T), std::move(v)); v.reset();
         }
     }
 
-    static void apply(ActionType a, void *p, VariableData *v) {
-        if (a == ActionType::destroy) { // Delete the object (known to be non-reference)
-            DUMP("delete ", typeid(T).name());
-            if constexpr(UseStack<T>::value) static_cast<T *>(p)->~T();
-            else delete static_cast<T *>(p);
-
-        } else if (a == ActionType::copy) { // Copy-Construct the object
-            DUMP(v->stack, UseStack<T>::value);
-            if constexpr(std::is_copy_constructible_v<T>) {
-                if constexpr(UseStack<T>::value) ::new(static_cast<void *>(&v->buff)) T(*static_cast<T const *>(p));
-                else reinterpret_cast<void *&>(v->buff) = ::new T(*static_cast<T const *>(p));
-            } else throw std::invalid_argument("not copyable");
-
-        } else if (a == ActionType::move) { // Move-Construct the object (known to be on stack)
-            DUMP(v->stack, UseStack<T>::value);
-            if constexpr(UseStack<T>::value) // this is always known, but eliminates compile warnings
-                ::new(static_cast<void *>(&v->buff)) T(std::move(*static_cast<T *>(p)));
-
-        } else if (a == ActionType::response) { // Respond to a given type_index
-            DUMP("response", v->idx.name(), typeid(T).name(), v->idx.qualifier());
-            response(reinterpret_cast<Variable &>(*v), p, std::move(reinterpret_cast<RequestData &>(v->buff)));
-
-        } else if (a == ActionType::assign) { // Assign from another variable
-            DUMP("assign", v->idx.name(), typeid(T).name(), v->idx.qualifier());
-            if constexpr(!std::is_abstract_v<T> &&  std::is_move_assignable_v<T>) {
-                if (auto r = reinterpret_cast<Variable &&>(*v).request<T>()) {
-                    DUMP("got the assignable", v->idx.name(), typeid(T).name(), v->idx.qualifier(), typeid(T).name());
-                    *static_cast<T *>(p) = std::move(*r);
-                    reinterpret_cast<Variable &>(*v).reset(); // signifies that assignment took place
-                }
+    /// Assign from another variable
+    static void assign(void *p, Variable &v) {
+        DUMP("assign", v.type(), typeid(T).name());
+        if constexpr(!std::is_abstract_v<T> &&  std::is_move_assignable_v<T>) {
+            if (auto r = std::move(v).request<T>()) {
+                DUMP("got the assignable", v.type(), typeid(T).name());
+                *static_cast<T *>(p) = std::move(*r);
+                v.reset(); // signifies that assignment took place
             }
         }
     }
+
+    static constexpr ActionTable table = {destroy, copy, move, response, assign,
+        std::is_trivially_copyable_v<T>, std::is_trivially_destructible_v<T>, IsTriviallyRelocatable<T>::value, Shared, UseRouteCache<T>::value};
+
+    /// Table of a heap held object placed by an Allocator, which differs only in how the object is freed
+    static constexpr ActionTable placed_table = {destroy_placed, copy, move, response, assign,
+        std::is_trivially_copyable_v<T>, std::is_trivially_destructible_v<T>, IsTriviallyRelocatable<T>::value, Shared, UseRouteCache<T>::value};
 };
 
 /******************************************************************************/
@@ -16,6 +16,11 @@ class Config:
         self.set_output_conversion = methods['set_output_conversion']
         self.set_input_conversion = methods['set_input_conversion']
         self.set_translation = methods['set_translation']
+        self._set_call_arena = methods['set_call_arena']
+        self._get_call_arena = methods['call_arena']
+        self._set_array_narrowing = methods['set_array_narrowing']
+        self._get_array_narrowing = methods['array_narrowing']
+        self.allocation_counters = methods['allocation_counters']
 
     @property
     def debug(self):
@@ -25,6 +30,22 @@ class Config:
     def debug(self, value):
         self._set_debug(bool(value))
 
+    @property
+    def call_arena(self):
+        return self._get_call_arena().cast(bool)
+
+    @call_arena.setter
+    def call_arena(self, value):
+        self._set_call_arena(bool(value))
+
+    @property
+    def array_narrowing(self):
+        return self._get_array_narrowing().cast(bool)
+
+    @array_narrowing.setter
+    def array_narrowing(self, value):
+        self._set_array_narrowing(bool(value))
+
 ################################################################################
 
 from .render import render_module, render_init, render_member, \
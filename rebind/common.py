@@ -91,7 +91,7 @@ def signatures(function):
     try:
         function = function.__kwdefaults__['_orig']
     except AttributeError:
-        pass
+        function = getattr(function, 'function', function) # AnnotatedFunction
     return function.signatures()
 
 ################################################################################
@@ -172,7 +172,8 @@ def render_object(pkg, key, value):
 
     old = common.unwrap(getattr(mod, key, None))
     if old is None:
-        pass
+        if callable(getattr(value, 'parameters', None)) and value.parameters():
+            value = render_function(value, None) # bind the parameters declared in C++
     elif callable(value):
         log.info("deriving function '%s.%s' from %s", mod.__name__, key, repr(old))
         assert callable(old), 'expected annotation to be a function'
@@ -188,14 +189,6 @@ def render_object(pkg, key, value):
 
 ################################################################################
 
-def make_callback(origin, types):
-    '''Make a callback that calls the wrapped one with arguments casted to the given types'''
-    if not callable(origin):
-        return origin
-    def callback(*args):
-        return origin(*(a.cast(t) for a, t in zip(args, types)))
-    return callback
-
 def is_callable_type(t):
     '''Detect whether a parameter to a C++ function is a callback'''
     t = getattr(t, '__origin__', None)
@@ -213,9 +206,12 @@ def render_function(fun, old):
     - Otherwise, call the document function
     '''
     if old is None:
-        def bound(*args, _orig=fun):
-            return _orig(*args)
-        return functools.update_wrapper(bound, common.opaque_signature)
+        if not hasattr(fun, 'annotated'): # a Python function, e.g. from render_init
+            def bound(*args, _orig=fun):
+                return _orig(*args)
+            return functools.update_wrapper(bound, common.opaque_signature)
+        # bind the parameters declared in C++ if there are any, else pass positional arguments through
+        return functools.update_wrapper(fun.annotated(), common.opaque_signature)
 
     if isinstance(old, property):
         return property(render_function(fun, old.fget))
@@ -233,35 +229,22 @@ def render_function(fun, old):
     if '_old' in sig.parameters:
         raise ValueError('Function {} was already wrapped'.format(old))
     
-    # Eventually all of the computation in wrap() could be moved into C++
-    # (1) binding of args and kwargs with default arguments
-    # (3) either cast the return type or invoke the fun that is given
     if has_fun:
         def wrap(*args, _orig=fun, _bind=sig.bind, _old=old, **kwargs):
             bound = _bind(*args, **kwargs)
             bound.apply_defaults()
             return _old(*bound.args, _fun_=_orig, **bound.kwargs)
-    else:
-        # for each arg that is annotated with Callback, make a callback out of it
-        types = tuple(p.annotation.__args__ if is_callable_type(p.annotation) else None for p in sig.parameters.values())
-        ret = sig.return_annotation
-
-        for k, p in sig.parameters.items():
-            if p.kind == p.VAR_KEYWORD or p.kind == p.VAR_POSITIONAL:
-                raise TypeError('Parameter {} cannot be variadic (e.g. like *args or **kwargs)'.format(k))
-
-        def wrap(*args, _orig=fun, _bind=sig.bind, _return=ret, gil=None, signature=None, **kwargs):
-            bound = _bind(*args, **kwargs)
-            bound.apply_defaults()
-            # Convert any keyword arguments into positional arguments
-            out = _orig(*(make_callback(a, t) if t is not None else a for a, t in zip(bound.arguments.values(), types)), gil=gil, signature=signature)
-            if _return is empty:
-                return out # no cast
-            if _return is None or _return is type(None):
-                return # return None regardless of output
-            if out is None:
-                raise TypeError('Expected {} but was returned object None'.format(_return))
-            return out.cast(_return)
-
+        return functools.update_wrapper(wrap, old)
+
+    for k, p in sig.parameters.items():
+        if p.kind == p.VAR_KEYWORD or p.kind == p.VAR_POSITIONAL:
+            raise TypeError('Parameter {} cannot be variadic (e.g. like *args or **kwargs)'.format(k))
+
+    # Keyword binding, defaults, callbacks and the return cast are done in C++
+    # Each argument annotated with Callback is wrapped so that its arguments are cast to the annotated types
+    params = sig.parameters.values()
+    wrap = fun.annotated(tuple(p.name for p in params), tuple(p.default for p in params),
+        tuple(p.annotation.__args__ if is_callable_type(p.annotation) else None for p in params),
+        sig.return_annotation, empty)
     return functools.update_wrapper(wrap, old)
 
@@ -0,0 +1,396 @@
+/**
+ * @brief Benchmark of Variable storage layouts: heap allocations and call throughput
+ * @file Benchmark.cc
+ */
+#include <rebind/Document.h>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <optional>
+
+/******************************************************************************/
+
+namespace {
+    std::size_t allocation_count = 0;
+}
+
+void * operator new(std::size_t n) {
+    ++allocation_count;
+    if (auto p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {std::free(p);}
+void operator delete(void *p, std::size_t) noexcept {std::free(p);}
+
+/******************************************************************************/
+
+namespace rebind {
+
+struct Small {double x, y, z;};
+
+struct alignas(16) Aligned {float x[4];};
+
+struct Large {double x[64];};
+
+struct SharedLarge {double x[64];};
+
+template <>
+struct UseShared<SharedLarge> : std::true_type {};
+
+/// Run f n times and print the allocations and time per iteration
+template <class F>
+void measure(char const *name, std::size_t n, F &&f) {
+    auto const a0 = allocation_count;
+    auto const t0 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i != n; ++i) f();
+    auto const t1 = std::chrono::steady_clock::now();
+    double const ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+    double const allocs = double(allocation_count - a0) / n;
+    std::cout << "    " << name << ": " << allocs << " allocations, " << ns << " ns" << std::endl;
+}
+
+Sequence make_arguments() {
+    Sequence s;
+    s.reserve(8);
+    s.emplace_back(1);
+    s.emplace_back(2.5);
+    s.emplace_back(static_cast<long double>(3.5));
+    s.emplace_back(static_cast<int *>(nullptr));
+    s.emplace_back(std::complex<double>(1, 2));
+    s.emplace_back(Small{1, 2, 3});
+    s.emplace_back(Aligned{{1, 2, 3, 4}});
+    s.emplace_back(std::string("short"));
+    return s;
+}
+
+/// Return allocations per call, excluding those made to copy the arguments in
+double call_allocations(Function const &f, Sequence const &args, std::size_t n) {
+    f(Caller(), Sequence(args)); // warm up the per-thread temporary arena and the route cache
+    std::size_t count = 0;
+    for (std::size_t i = 0; i != n; ++i) {
+        Sequence s = args;
+        auto const a0 = allocation_count;
+        f(Caller(), std::move(s));
+        count += allocation_count - a0;
+    }
+    return double(count) / n;
+}
+
+Function primitive_function() {
+    return Function::of([](int i, double d, double const &r, bool b) {return b ? i + d + r : 0.0;});
+}
+
+Sequence primitive_arguments() {
+    return {Variable(1), Variable(2), Variable(3), Variable(true)};
+}
+
+/// Print the outcome of a regression check and return whether it passed
+bool expect(char const *name, bool ok) {
+    std::cout << name << ": " << (ok ? "passed" : "FAILED") << std::endl;
+    return ok;
+}
+
+/// A rejected value must not make the route cache reject other values of the same type
+bool check_route_cache() {
+    bool const rejected = !Variable(Integer(300)).request<unsigned char>();
+    return expect("route cache after out of range value", rejected && Variable(Integer(5)).request<unsigned char>() == 5);
+}
+
+/// A Mismatch must keep its messages after its Dispatch and the temporary arena are gone
+bool check_mismatch_lifetime() {
+    Mismatch first;
+    {
+        Dispatch msg;
+        msg.error(std::string_view("first message"));
+        msg.source = {copy_temporary("first source")};
+        first = msg.mismatch();
+    }
+    {
+        Dispatch msg;
+        msg.error(std::string_view("second overload message!!!"));
+        msg.source = {copy_temporary("second source!!!")};
+    }
+    return expect("mismatch after its dispatch", first.scope == "first message" && first.source_str() == "first source");
+}
+
+/// A narrowing vector conversion is made element-wise with range checks unless ArrayNarrowing is set
+bool check_narrowing_vector() {
+    auto const small = Variable(std::vector<long long>{1, 2, 3}).request<std::vector<int>>();
+    auto const large = Variable(std::vector<long long>{1ll << 40}).request<std::vector<int>>();
+    auto const real = Variable(std::vector<double>{1.5}).request<std::vector<float>>();
+    return expect("narrowing vector conversion", small == std::vector<int>{1, 2, 3} && !large && real == std::vector<float>{1.5f});
+}
+
+/// An Integer requested as a narrower integer type fails if out of range instead of wrapping around
+bool check_integer_request() {
+    auto const request = [](auto t, Integer i) {return Variable(i).request<decltype(t)>();};
+    Integer const int_min = std::numeric_limits<int>::min(), uint8_max = std::numeric_limits<std::uint8_t>::max();
+    bool ok = request(int(), int_min) == std::numeric_limits<int>::min() && !request(int(), int_min - 1);
+    ok &= request(int(), -int_min - 1) == std::numeric_limits<int>::max() && !request(int(), -int_min);
+    ok &= request(std::uint8_t(), uint8_max) == uint8_max && !request(std::uint8_t(), uint8_max + 1);
+    ok &= request(std::uint8_t(), 0) == 0u && !request(std::uint8_t(), -1);
+    ok &= !request(unsigned(), -1) && !request(std::size_t(), std::numeric_limits<Integer>::min());
+    ok &= request(std::size_t(), std::numeric_limits<Integer>::max()) == std::size_t(std::numeric_limits<Integer>::max());
+    ok &= request(bool(), 2) == true && request(bool(), 0) == false;
+    return expect("narrowing integer request", ok);
+}
+
+/// A narrowing integer array conversion fails on a value out of range instead of wrapping around
+bool check_integer_narrowing() {
+    long long const data[] = {255, 0, 300, -1};
+    unsigned char out[2];
+    auto const convert = [&](long long const *p, std::ptrdiff_t stride) {
+        return convert_array(out, typeid(unsigned char), p, typeid(long long),
+                             ArrayLayout(std::array<std::size_t, 1>{2}, std::array<std::ptrdiff_t, 1>{stride}), true);
+    };
+    bool ok = convert(data, 1) == ArrayConversion::ok && out[0] == 255 && out[1] == 0;
+    ok &= convert(data + 1, 1) == ArrayConversion::out_of_range && convert(data + 2, 1) == ArrayConversion::out_of_range;
+    ok &= convert(data, 3) == ArrayConversion::out_of_range && convert(data + 1, 2) == ArrayConversion::out_of_range;
+    ok &= convert(data + 3, -1) == ArrayConversion::out_of_range;
+    ok &= convert(data + 1, -1) == ArrayConversion::ok && out[0] == 0 && out[1] == 255;
+    return expect("narrowing integer array conversion", ok);
+}
+
+/// Convert n values of S laid out stride apart (contiguous if stride is 1, reversed if negative) into D
+template <class D, class S>
+ArrayConversion convert_spaced(D *out, S const *values, std::size_t n, std::ptrdiff_t stride) {
+    std::size_t const step = static_cast<std::size_t>(stride < 0 ? -stride : stride);
+    std::unique_ptr<S[]> spaced(new S[n * step]());
+    S *base = spaced.get() + (stride < 0 ? (n - 1) * step : 0);
+    for (std::size_t i = 0; i != n; ++i) base[static_cast<std::ptrdiff_t>(i) * stride] = values[i];
+    return convert_array(out, typeid(D), base, typeid(S),
+                         ArrayLayout(std::array<std::size_t, 1>{n}, std::array<std::ptrdiff_t, 1>{stride}), true);
+}
+
+/// The kernel from S to D agrees with static_cast for values D can hold, contiguous and strided
+template <class D, class S>
+bool check_array_kernel() {
+    constexpr std::size_t n = 67; // not a multiple of any vector width
+    constexpr bool negative = std::is_signed_v<D> && std::is_signed_v<S>;
+    S values[n];
+    D expected[n], out[n];
+    for (std::size_t i = 0; i != n; ++i) {
+        if constexpr(std::is_same_v<S, bool>) values[i] = i % 3 == 0;
+        else values[i] = static_cast<S>(static_cast<int>(i % 100) - (negative ? 50 : 0));
+        if constexpr(std::is_floating_point_v<S>) values[i] += (negative || !std::is_integral_v<D>) ? S(-0.75) : S(0.75);
+        expected[i] = static_cast<D>(values[i]);
+    }
+    bool ok = true;
+    for (std::ptrdiff_t stride : {1, 3, -2})
+        ok &= convert_spaced(out, values, n, stride) == ArrayConversion::ok && std::equal(out, out + n, expected);
+    return ok;
+}
+
+template <class D, class ...Ss>
+bool check_array_kernels_to(Pack<Ss...>) {return (check_array_kernel<D, Ss>() & ...);}
+
+/// Built-in arithmetic types between which arrays are converted
+using ArrayTypes = Pack<bool, char, signed char, unsigned char, short, unsigned short, int, unsigned int,
+                        long, unsigned long, long long, unsigned long long, float, double>;
+
+template <class ...Ds>
+bool check_array_kernels(Pack<Ds...>) {return (check_array_kernels_to<Ds>(ArrayTypes()) & ...);}
+
+/// Convert x after in range zeros, so that it falls in the tail of a vectorized loop; expect the given result,
+/// or a failure if there is none
+template <class D, class S>
+bool check_array_edge(S x, std::optional<D> expected) {
+    constexpr std::size_t n = 41;
+    S values[n] = {};
+    values[n - 1] = x;
+    D out[n];
+    bool ok = true;
+    for (std::ptrdiff_t stride : {1, 2, -3}) {
+        auto const r = convert_spaced(out, values, n, stride);
+        ok &= expected ? r == ArrayConversion::ok && out[n - 1] == *expected : r == ArrayConversion::out_of_range;
+    }
+    return ok;
+}
+
+/// Array conversion kernels agree with static_cast, and reject exactly the floating point values out of range
+bool check_array_conversions() {
+    using LL = std::numeric_limits<long long>;
+    double const nan = std::numeric_limits<double>::quiet_NaN(), p31 = std::ldexp(1.0, 31), p63 = std::ldexp(1.0, 63);
+    bool ok = check_array_kernels(ArrayTypes());
+    ok &= check_array_edge<int>(nan, {}) && check_array_edge<unsigned char>(float(nan), {});
+    ok &= check_array_edge<unsigned int>(-0.5, 0u) && check_array_edge<unsigned char>(-0.5f, 0);
+    ok &= check_array_edge<unsigned int>(-1.0, {});
+    ok &= check_array_edge<int>(p31, {}) && check_array_edge<int>(p31 - 1, std::numeric_limits<int>::max());
+    ok &= check_array_edge<int>(float(p31), {}) && check_array_edge<int>(std::nextafter(float(p31), 0.f), 2147483520);
+    ok &= check_array_edge<int>(-p31 - 0.5, std::numeric_limits<int>::min()) && check_array_edge<int>(-p31 - 1, {});
+    ok &= check_array_edge<long long>(-p63, LL::min()) && check_array_edge<long long>(std::nextafter(-p63, -HUGE_VAL), {});
+    ok &= check_array_edge<long long>(float(-p63), LL::min()) && check_array_edge<long long>(p63, {});
+    ok &= check_array_edge<unsigned long long>(2 * p63, {})
+        && check_array_edge<unsigned long long>(std::nextafter(2 * p63, 0.0), std::nextafter(2 * p63, 0.0));
+    return expect("array conversion kernels", ok);
+}
+
+/// Copy an array element by element, as a reference for copy_array()
+void naive_copy(char *out, ArrayLayout const &to, char const *data, ArrayLayout const &from, std::size_t itemsize) {
+    std::vector<std::size_t> index(to.depth());
+    for (std::size_t k = 0; k != to.n_elem(); ++k) {
+        std::ptrdiff_t o = 0, i = 0;
+        for (std::size_t d = 0; d != to.depth(); ++d)
+            o += static_cast<std::ptrdiff_t>(index[d]) * to.stride(d), i += static_cast<std::ptrdiff_t>(index[d]) * from.stride(d);
+        std::memcpy(out + o * static_cast<std::ptrdiff_t>(itemsize), data + i * static_cast<std::ptrdiff_t>(itemsize), itemsize);
+        for (std::size_t d = to.depth(); d-- != 0 && ++index[d] == to.shape(d);) index[d] = 0;
+    }
+}
+
+/// copy_array() and copy_contiguous() (used to export a strided buffer) agree with an element by element copy for
+/// transposed, sliced, negatively strided, size 1 and size 0 layouts, and items of unusual sizes
+bool check_copy_array() {
+    using Dims = std::vector<std::size_t>;
+    using Strides = std::vector<std::ptrdiff_t>;
+    std::pair<Dims, Strides> const layouts[] = {
+        {{3, 4}, {1, 3}}, {{3, 4}, {-4, -1}}, {{3, 4}, {4, -1}}, {{2, 3, 4}, {12, 4, 1}}, {{2, 3, 4}, {32, 8, 2}},
+        {{4, 2, 3}, {1, 12, 4}}, {{1, 5, 1}, {100, -2, 7}}, {{3, 0, 2}, {2, 6, 1}}, {{7}, {-3}}, {{1}, {5}}};
+    std::vector<char> source(8192);
+    for (std::size_t i = 0; i != source.size(); ++i) source[i] = static_cast<char>(i * 7 % 251);
+    char const *data = source.data() + source.size() / 2; // room for negative strides
+    bool ok = true;
+    for (std::size_t itemsize : {1, 2, 3, 4, 8, 12}) {
+        for (auto const &[shape, strides] : layouts) {
+            ArrayLayout const from(shape, strides);
+            std::size_t const bytes = from.n_elem() * itemsize;
+            for (bool fortran : {false, true}) {
+                auto const to = from.contiguous(fortran);
+                std::vector<char> expected(bytes + 1, 'x'), copied(bytes + 1, 'x'), exported(bytes + 1, 'x');
+                naive_copy(expected.data(), to, data, from, itemsize);
+                copy_array(copied.data(), to, data, from, itemsize);
+                auto const layout = copy_contiguous(exported.data(), data, from, itemsize, fortran);
+                ok &= copied == expected && exported == expected && layout.contents == to.contents;
+            }
+        }
+    }
+    return expect("strided array copy", ok);
+}
+
+/// Copying a shared payload adds an owner, and mutable access then makes a private copy
+bool check_shared_copy() {
+    Variable const v{SharedLarge()};
+    Variable c = v.copy();
+    bool const shared = c.data() == v.data();
+    c.reference();
+    return expect("copy of shared payload", shared && c.data() != v.data());
+}
+
+/// Payloads placed by an Arena outlive it, and copies made without an Allocator are freed from the global heap
+bool check_placed_payload() {
+    auto const absorbed = allocation_counters.absorbed.load();
+    Variable large, shared;
+    {
+        Arena arena;
+        AllocatorScope scope(&arena);
+        large = Large{{1}};
+        shared = SharedLarge{{2}};
+    }
+    bool ok = allocation_counters.absorbed.load() == absorbed + 2;
+    Variable const copies[] = {large, shared, large.copy(), shared.copy()};
+    shared.reference().target<SharedLarge &>()->x[0] = 3; // unshared to the global heap
+    {
+        Arena arena;
+        AllocatorScope scope(&arena);
+        Variable placed = copies[3];
+        placed.reference(); // unshared into the arena, while the original stays on the global heap
+    }
+    ok &= copies[2].target<Large const &>()->x[0] == 1 && copies[3].target<SharedLarge const &>()->x[0] == 2;
+    return expect("payload placed by an arena", ok);
+}
+
+/// Check that a call with primitive arguments (including conversions and temporaries) does not allocate,
+/// and run the regression checks
+int check(std::size_t n) {
+    double const allocs = call_allocations(primitive_function(), primitive_arguments(), n);
+    std::cout << "call with 4 primitive arguments: " << allocs << " allocations" << std::endl;
+    bool ok = allocs == 0;
+    ok &= check_route_cache();
+    ok &= check_mismatch_lifetime();
+    ok &= check_narrowing_vector();
+    ok &= check_integer_request();
+    ok &= check_integer_narrowing();
+    ok &= check_array_conversions();
+    ok &= check_copy_array();
+    ok &= check_shared_copy();
+    ok &= check_placed_payload();
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int run(std::size_t n) {
+    std::cout << "Variable layout: capacity=" << sizeof(Storage) << " alignment=" << alignof(Storage)
+              << " sizeof(Variable)=" << sizeof(Variable) << std::endl;
+
+    measure("construct 8 arguments", n, [] {
+        Sequence s = make_arguments();
+    });
+
+    Sequence const args = make_arguments();
+    measure("copy 8 arguments", n, [&] {
+        Sequence s = args;
+    });
+
+    measure("copy 8 arguments in an arena", n, [&] {
+        Arena arena;
+        AllocatorScope scope(&arena);
+        Sequence s = args;
+    });
+
+    Variable const large{Large()}, shared{SharedLarge()};
+    measure("copy large argument", n, [&] {
+        Variable v = large;
+    });
+
+    measure("copy shared large argument", n, [&] {
+        Variable v = shared;
+    });
+
+    measure("copy() shared large argument", n, [&] {
+        Variable v = shared.copy();
+    });
+
+    double total = 0;
+    Variable const integer(1);
+    measure("convert int to double", n, [&] {
+        total += *integer.request<double>();
+    });
+
+    measure("fail to convert int to string", n, [&] {
+        total += integer.request<std::string>().has_value();
+    });
+
+    measure("grow 256 arguments", n / 32, [] {
+        Sequence s;
+        for (int i = 0; i != 256; ++i) s.emplace_back(i);
+    });
+
+    std::cout << "    call with 4 primitive arguments: "
+              << call_allocations(primitive_function(), primitive_arguments(), n) << " allocations" << std::endl;
+
+    auto f = Function::of([](int i, double d, long double l, Small const &s, Aligned const &a) {
+        return i + d + static_cast<double>(l) + s.x + a.x[0];
+    });
+    Sequence const call_args = {Variable(1), Variable(2.5), Variable(static_cast<long double>(3.5)),
+                                Variable(Small{1, 2, 3}), Variable(Aligned{{1, 2, 3, 4}})};
+    measure("call with 5 arguments", n, [&] {
+        total += *f(Caller(), Sequence(call_args)).target<double const &>();
+    });
+    return total > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}
+
+/******************************************************************************/
+
+/// Usage: rebindbenchmark_<capacity>_<alignment> [--check] [iterations]
+int main(int argc, char **argv) {
+    bool const check = argc > 1 && std::string_view(argv[1]) == "--check";
+    if (check) {--argc; ++argv;}
+    std::size_t const n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    return check ? rebind::check(n) : rebind::run(n);
+}
@@ -1,5 +1,7 @@
 #include <rebind-python/Cast.h>
 #include <numeric>
+#include <map>
+#include <typeindex>
 
 namespace rebind {
 
@@ -26,73 +28,203 @@ Object type_args(Object const &o, Py_ssize_t n) {
     return out;
 }
 
-Object list_cast(Variable &&ref, Object const &o, Object const &root) {
-    DUMP("Cast to list ", ref.type());
-    if (auto args = type_args(o, 1)) {
-        DUMP("is list ", PyList_Check(o));
-        auto v = ref.cast<Sequence>();
-        Object vt{PyTuple_GET_ITEM(+args, 0), true};
-        auto list = Object::from(PyList_New(v.size()));
-        for (Py_ssize_t i = 0; i != v.size(); ++i) {
-            DUMP("list index ", i);
-            Object item = python_cast(std::move(v[i]), vt, root);
-            if (!item) return {};
-            incref(+item);
-            PyList_SET_ITEM(+list, i, +item);
+/// Conversion of a Variable to a Python type annotation, compiled once per annotation object
+struct CastPlan {
+    enum Step : unsigned char {unknown, none, boolean, integer, real, str, bytes, deduced, variable,
+        type_index, function, memoryview, typed, list, tuple, tuple_of, dict, str_dict, union_of, conversion};
+    Step step = unknown;
+    Object type; //< the annotation as given, for error messages
+    Object target; //< the annotation after translation, or the output conversion function
+    Vector<CastPlan> args; //< plans of the annotation arguments
+};
+
+Object plan_cast(Variable &&v, CastPlan const &p, Object const &root);
+Object try_plan_cast(Variable &&v, CastPlan const &p, Object const &root);
+
+/******************************************************************************/
+
+/// Writer of a primitive C++ value as a new Python reference
+template <class T>
+using PrimitiveWriter = PyObject *(*)(T const &);
+
+/// Writer giving the same result as casting a Variable holding T with plan step s, or null if the
+/// step is not one of the simple conversions of T
+template <class T>
+PrimitiveWriter<T> primitive_writer(CastPlan::Step s) noexcept {
+    if constexpr(std::is_arithmetic_v<T>) switch (s) {
+        case CastPlan::boolean: return [](T const &t) {
+            PyObject *o = static_cast<bool>(static_cast<Integer>(t)) ? Py_True : Py_False;
+            return incref(o), o;
+        };
+        case CastPlan::integer: return [](T const &t) {return PyLong_FromLongLong(static_cast<Integer>(t));};
+        case CastPlan::real: // the deduced conversion of a number is also via Real
+        case CastPlan::deduced: return [](T const &t) {return PyFloat_FromDouble(static_cast<Real>(t));};
+        default: return nullptr;
+    } else switch (s) {
+        case CastPlan::str:
+        case CastPlan::deduced: return [](T const &t) {
+            return PyUnicode_FromStringAndSize(t.data(), static_cast<Py_ssize_t>(t.size()));
+        };
+        default: return nullptr;
+    }
+}
+
+/// Fill a new list or tuple of size n by calling f(i) for each index, which returns a new reference
+template <class F>
+Object native_sequence(bool list, std::size_t n, F &&f) {
+    auto out = Object::from(list ? PyList_New(n) : PyTuple_New(n));
+    for (std::size_t i = 0; i != n; ++i) {
+        PyObject *x = f(i);
+        if (!x) return {};
+        if (list) PyList_SET_ITEM(+out, i, x);
+        else PyTuple_SET_ITEM(+out, i, x);
+    }
+    return out;
+}
+
+/// Direct conversion of a standard container of primitives, without a Variable per item.
+/// Returns null without an error if the plan is not handled, so that the generic cast is used instead
+template <class V, class SFINAE=void>
+struct NativeCast;
+
+template <class T, class A>
+struct NativeCast<std::vector<T, A>> {
+    Object operator()(std::vector<T, A> const &v, CastPlan const &p) const {
+        if (p.step != CastPlan::list && p.step != CastPlan::tuple_of) return {};
+        auto const write = primitive_writer<T>(p.args[0].step);
+        if (!write) return {};
+        return native_sequence(p.step == CastPlan::list, v.size(), [&](std::size_t i) {return write(v[i]);});
+    }
+};
+
+template <class K, class T, class C, class A>
+struct NativeCast<std::map<K, T, C, A>> {
+    Object operator()(std::map<K, T, C, A> const &v, CastPlan const &p) const {
+        if (p.step == CastPlan::dict || p.step == CastPlan::str_dict) {
+            auto const key = primitive_writer<K>(p.args[0].step);
+            auto const val = primitive_writer<T>(p.args[1].step);
+            if (!key || !val) return {};
+            auto out = Object::from(PyDict_New());
+            for (auto const &x : v) {
+                Object const k(key(x.first), false), t(val(x.second), false);
+                if (!k || !t || PyDict_SetItem(+out, +k, +t)) return {};
+            }
+            return out;
         }
-        return list;
-    } else return {};
+        if (p.step != CastPlan::list && p.step != CastPlan::tuple_of) return {};
+        auto const &item = p.args[0]; // List[Tuple[K, T]] or Tuple[Tuple[K, T], ...]
+        if (item.step != CastPlan::tuple || item.args.size() != 2) return {};
+        auto const key = primitive_writer<K>(item.args[0].step);
+        auto const val = primitive_writer<T>(item.args[1].step);
+        if (!key || !val) return {};
+        auto it = v.begin();
+        return native_sequence(p.step == CastPlan::list, v.size(), [&](std::size_t) -> PyObject * {
+            auto const &x = *it++;
+            Object k(key(x.first), false), t(val(x.second), false);
+            return k && t ? PyTuple_Pack(2, +k, +t) : nullptr;
+        });
+    }
+};
+
+using NativeCastFunction = Object (*)(Variable const &, CastPlan const &);
+
+template <class V>
+Object native_cast(Variable const &v, CastPlan const &p) {
+    if (auto t = v.target<V const &>()) return NativeCast<V>()(*t, p);
+    return {};
+}
+
+/// Primitive item types of the containers which are converted natively
+using NativeItems = Pack<bool, short, unsigned short, int, unsigned int, long, unsigned long,
+    long long, unsigned long long, float, double, std::string, std::string_view>;
+
+/// Key types of the maps which are converted natively
+using NativeKeys = Pack<int, unsigned int, long, unsigned long, long long, std::string>;
+
+template <class K, class ...Ts>
+void add_native_maps(std::unordered_map<std::type_index, NativeCastFunction> &m, Pack<Ts...>) {
+    (m.emplace(typeid(std::map<K, Ts>), native_cast<std::map<K, Ts>>), ...);
+}
+
+template <class ...Ts, class ...Ks>
+std::unordered_map<std::type_index, NativeCastFunction> make_native_casts(Pack<Ts...>, Pack<Ks...>) {
+    std::unordered_map<std::type_index, NativeCastFunction> out;
+    (out.emplace(typeid(std::vector<Ts>), native_cast<std::vector<Ts>>), ...);
+    (add_native_maps<Ks>(out, Pack<Ts...>()), ...);
+    return out;
+}
+
+/// Native conversions keyed by the held C++ container type
+auto const native_casts = make_native_casts(NativeItems(), NativeKeys());
+
+/// Convert a held standard container directly if possible, else return null (with an error only if one occurred)
+Object try_native_cast(Variable const &v, CastPlan const &p) {
+    if (!v.has_value()) return {};
+    auto it = native_casts.find(v.type().info());
+    return it == native_casts.end() ? Object() : it->second(v, p);
+}
+
+/******************************************************************************/
+
+Object list_cast(Variable &&ref, CastPlan const &p, Object const &root) {
+    DUMP("Cast to list ", ref.type());
+    if (auto o = try_native_cast(ref, p); o || PyErr_Occurred()) return o;
+    auto v = ref.cast<Sequence>();
+    auto list = Object::from(PyList_New(v.size()));
+    for (Py_ssize_t i = 0; i != v.size(); ++i) {
+        DUMP("list index ", i);
+        Object item = plan_cast(std::move(v[i]), p.args[0], root);
+        if (!item) return {};
+        incref(+item);
+        PyList_SET_ITEM(+list, i, +item);
+    }
+    return list;
 }
 
-Object tuple_cast(Variable &&ref, Object const &o, Object const &root) {
+Object tuple_cast(Variable &&ref, CastPlan const &p, Object const &root) {
     DUMP("Cast to tuple ", ref.type());
-    if (auto args = type_args(o)) {
-        Py_ssize_t const len = PyTuple_GET_SIZE(+args);
-        auto v = ref.cast<Sequence>();
-        if (len == 2 && PyTuple_GET_ITEM(+args, 1) == Py_Ellipsis) {
-            Object vt{PyTuple_GET_ITEM(+args, 0), true};
-            auto tup = Object::from(PyTuple_New(v.size()));
-            for (Py_ssize_t i = 0; i != v.size(); ++i)
-                if (!set_tuple_item(tup, i, python_cast(std::move(v[i]), vt, root))) return {};
-            return tup;
-        } else if (len == v.size()) {
-            auto tup = Object::from(PyTuple_New(len));
-            for (Py_ssize_t i = 0; i != len; ++i)
-                if (!set_tuple_item(tup, i, python_cast(std::move(v[i]), {PyTuple_GET_ITEM(+args, i), true}, root))) return {};
-            return tup;
-        }
+    if (auto o = try_native_cast(ref, p); o || PyErr_Occurred()) return o;
+    auto v = ref.cast<Sequence>();
+    if (p.step == CastPlan::tuple_of) { // Tuple[T, ...]
+        auto tup = Object::from(PyTuple_New(v.size()));
+        for (Py_ssize_t i = 0; i != v.size(); ++i)
+            if (!set_tuple_item(tup, i, plan_cast(std::move(v[i]), p.args[0], root))) return {};
+        return tup;
+    } else if (p.args.size() == v.size()) {
+        auto tup = Object::from(PyTuple_New(v.size()));
+        for (Py_ssize_t i = 0; i != v.size(); ++i)
+            if (!set_tuple_item(tup, i, plan_cast(std::move(v[i]), p.args[i], root))) return {};
+        return tup;
     }
     return {};
 }
 
-Object dict_cast(Variable &&ref, Object const &o, Object const &root) {
+Object dict_cast(Variable &&ref, CastPlan const &p, Object const &root) {
     DUMP("Cast to dict ", ref.type());
-    if (auto args = type_args(o, 2)) {
-        Object key{PyTuple_GET_ITEM(+args, 0), true};
-        Object val{PyTuple_GET_ITEM(+args, 1), true};
-
-        if (+key == SubClass<PyTypeObject>{&PyUnicode_Type}) {
-            if (auto v = ref.request<Dictionary>()) {
-                auto out = Object::from(PyDict_New());
-                for (auto &x : *v) {
-                    Object k = as_object(x.first);
-                    Object v = python_cast(std::move(x.second), val, root);
-                    if (!k || !v || PyDict_SetItem(out, k, v)) return {};
-                }
-                return out;
-            }
-        }
+    if (auto o = try_native_cast(ref, p); o || PyErr_Occurred()) return o;
+    auto const &key = p.args[0], &val = p.args[1];
 
-        if (auto v = ref.request<Vector<std::pair<Variable, Variable>>>()) {
+    if (p.step == CastPlan::str_dict) {
+        if (auto v = ref.request<Dictionary>()) {
             auto out = Object::from(PyDict_New());
             for (auto &x : *v) {
-                Object k = python_cast(std::move(x.first), key, root);
-                Object v = python_cast(std::move(x.second), val, root);
+                Object k = as_object(x.first);
+                Object v = plan_cast(std::move(x.second), val, root);
                 if (!k || !v || PyDict_SetItem(out, k, v)) return {};
             }
             return out;
         }
     }
+
+    if (auto v = ref.request<Vector<std::pair<Variable, Variable>>>()) {
+        auto out = Object::from(PyDict_New());
+        for (auto &x : *v) {
+            Object k = plan_cast(std::move(x.first), key, root);
+            Object v = plan_cast(std::move(x.second), val, root);
+            if (!k || !v || PyDict_SetItem(out, k, v)) return {};
+        }
+        return out;
+    }
     return {};
 }
 
@@ -165,6 +297,7 @@ Object function_cast(Variable &&ref) {
 }
 
 Object memoryview_cast(Variable &&ref, Object const &root) {
+    if (is_owned_array(ref, root)) return Object::from(PyMemoryView_FromObject(+root)); // tracks the exports
     if (auto p = ref.request<ArrayView>()) {
         auto x = type_object<ArrayBuffer>();
         auto obj = Object::from(PyObject_CallObject(x, nullptr));
@@ -201,77 +334,170 @@ bool is_structured_type(PyObject *type, PyTypeObject *origin) {
     }
 }
 
-Object union_cast(Variable &&v, Object const &t, Object const &root) {
-    if (auto args = type_args(t)) {
-        auto const n = PyTuple_GET_SIZE(+args);
-        for (Py_ssize_t i = 0; i != n; ++i) {
-            Object o = python_cast(std::move(v), {PyTuple_GET_ITEM(+args, i), true}, root);
-            if (o) return o;
-            else PyErr_Clear();
-        }
+Object union_cast(Variable &&v, CastPlan const &p, Object const &root) {
+    for (auto const &a : p.args) {
+        Object o = try_plan_cast(std::move(v), a, root); // skip formatting a message for each failure
+        if (o) return o;
+        else PyErr_Clear();
     }
-    return type_error("cannot convert value to %R from type %S", +t, +type_index_cast(v.type()));
+    return type_error("cannot convert value to %R from type %S", +p.type, +type_index_cast(v.type()));
 }
 
+/******************************************************************************/
+
+/// Plans of the elements of t.__args__, which should have n elements if n is not -1
+Vector<CastPlan> compile_args(Object const &t, Py_ssize_t n=-1);
 
-// Convert C++ Variable to a requested Python type
-// First explicit types are checked:
+// Interpret an annotation: first explicit types are checked:
 // None, object, bool, int, float, str, bytes, TypeIndex, list, tuple, dict, Variable, Function, memoryview
 // Then, the output_conversions map is queried for Python function callable with the Variable
-Object try_python_cast(Variable &&v, Object const &t, Object root) {
-    DUMP("try_python_cast ", v.type(), " of qualifier ", v.qualifier());
+CastPlan compile_cast(Object const &type, Object const &t) {
     if (auto it = type_translations.find(t); it != type_translations.end()) {
         DUMP("type_translation found");
-        return try_python_cast(std::move(v), it->second, std::move(root));
-    } else if (PyType_CheckExact(+t)) {
+        return compile_cast(type, it->second);
+    }
+    CastPlan p;
+    p.type = type;
+    p.target = t;
+    if (PyType_CheckExact(+t)) {
         auto type = reinterpret_cast<PyTypeObject *>(+t);
         DUMP("is Variable ", is_subclass(type, type_object<Variable>()));
-        if (+type == Py_None->ob_type || +t == Py_None)       return {Py_None, true};                        // NoneType
-        else if (type == &PyBool_Type)                        return bool_cast(std::move(v));                // bool
-        else if (type == &PyLong_Type)                        return int_cast(std::move(v));                 // int
-        else if (type == &PyFloat_Type)                       return float_cast(std::move(v));               // float
-        else if (type == &PyUnicode_Type)                     return str_cast(std::move(v));                 // str
-        else if (type == &PyBytes_Type)                       return bytes_cast(std::move(v));               // bytes
-        else if (type == &PyBaseObject_Type)                  return as_deduced_object(std::move(v));        // object
-        else if (is_subclass(type, type_object<Variable>()))  return variable_cast(std::move(v), std::move(root), t);         // Variable
-        else if (type == type_object<TypeIndex>())            return type_index_cast(std::move(v));          // type(TypeIndex)
-        else if (type == type_object<Function>())             return function_cast(std::move(v));            // Function
-        else if (is_subclass(type, &PyFunction_Type))         return function_cast(std::move(v));            // Function
-        else if (type == &PyMemoryView_Type)                  return memoryview_cast(std::move(v), std::move(root));    // memory_view
+        if (+type == Py_None->ob_type || +t == Py_None)       p.step = CastPlan::none;         // NoneType
+        else if (type == &PyBool_Type)                        p.step = CastPlan::boolean;      // bool
+        else if (type == &PyLong_Type)                        p.step = CastPlan::integer;      // int
+        else if (type == &PyFloat_Type)                       p.step = CastPlan::real;         // float
+        else if (type == &PyUnicode_Type)                     p.step = CastPlan::str;          // str
+        else if (type == &PyBytes_Type)                       p.step = CastPlan::bytes;        // bytes
+        else if (type == &PyBaseObject_Type)                  p.step = CastPlan::deduced;      // object
+        else if (is_subclass(type, type_object<Variable>()))  p.step = CastPlan::variable;     // Variable
+        else if (type == type_object<TypeIndex>())            p.step = CastPlan::type_index;   // type(TypeIndex)
+        else if (type == type_object<Function>())             p.step = CastPlan::function;     // Function
+        else if (is_subclass(type, &PyFunction_Type))         p.step = CastPlan::function;     // Function
+        else if (type == &PyMemoryView_Type)                  p.step = CastPlan::memoryview;   // memory_view
     } else {
         DUMP("Not type and not in translations");
-        if (auto p = cast_if<TypeIndex>(t)) { // TypeIndex
-            Dispatch msg;
-            if (auto var = std::move(v).request_variable(msg, *p))
-                return variable_cast(std::move(var), std::move(root));
-            std::string c1 = v.type().name(), c2 = p->name();
-            return type_error("could not convert object of type %s to type %s", c1.data(), c2.data());
+        if (cast_if<TypeIndex>(t)) p.step = CastPlan::typed; // TypeIndex
+        else if (is_structured_type(t, UnionType)) {
+            p.step = CastPlan::union_of;
+            p.args = compile_args(t);
+        } else if (is_structured_type(t, &PyList_Type)) { // List[T] for some T (compound type)
+            p.step = CastPlan::list;
+            p.args = compile_args(t, 1);
+        } else if (is_structured_type(t, &PyTuple_Type)) { // Tuple[Ts...] for some Ts... (compound type)
+            auto args = type_args(t);
+            bool const variadic = PyTuple_GET_SIZE(+args) == 2 && PyTuple_GET_ITEM(+args, 1) == Py_Ellipsis;
+            p.step = variadic ? CastPlan::tuple_of : CastPlan::tuple;
+            p.args = compile_args(t, variadic ? 2 : -1);
+            if (variadic) p.args.pop_back();
+        } else if (is_structured_type(t, &PyDict_Type)) { // Dict[K, V] for some K, V (compound type)
+            auto args = type_args(t, 2);
+            p.step = PyTuple_GET_ITEM(+args, 0) == SubClass<PyTypeObject>{&PyUnicode_Type} ? CastPlan::str_dict : CastPlan::dict;
+            p.args = compile_args(t, 2);
         }
-        else if (is_structured_type(t, UnionType))     return union_cast(std::move(v), t, std::move(root));
-        else if (is_structured_type(t, &PyList_Type))  return list_cast(std::move(v), t, std::move(root));       // List[T] for some T (compound type)
-        else if (is_structured_type(t, &PyTuple_Type)) return tuple_cast(std::move(v), t, std::move(root));      // Tuple[Ts...] for some Ts... (compound type)
-        else if (is_structured_type(t, &PyDict_Type))  return dict_cast(std::move(v), t, std::move(root));       // Dict[K, V] for some K, V (compound type)
         DUMP("Not one of the structure types");
     }
+    if (p.step != CastPlan::unknown) return p;
 
     DUMP("custom convert ", output_conversions.size());
-    if (auto p = output_conversions.find(t); p != output_conversions.end()) {
-        DUMP(" conversion ");
-        Object o = variable_cast(std::move(v), std::move(root));
-        if (!o) return type_error("could not cast Variable to Python object");
-        DUMP("calling function");
-        return Object::from(PyObject_CallFunctionObjArgs(+p->second, +o, nullptr));
+    if (auto it = output_conversions.find(t); it != output_conversions.end()) {
+        p.step = CastPlan::conversion;
+        p.target = it->second;
     }
+    return p;
+}
 
+Vector<CastPlan> compile_args(Object const &t, Py_ssize_t n) {
+    auto args = n == -1 ? type_args(t) : type_args(t, n);
+    Vector<CastPlan> out;
+    out.reserve(PyTuple_GET_SIZE(+args));
+    for (Py_ssize_t i = 0; i != PyTuple_GET_SIZE(+args); ++i) {
+        if (PyTuple_GET_ITEM(+args, i) == Py_Ellipsis) out.emplace_back(); // only used as a placeholder
+        else {
+            Object a{PyTuple_GET_ITEM(+args, i), true};
+            out.emplace_back(compile_cast(a, a));
+        }
+    }
+    return out;
+}
+
+/******************************************************************************/
+
+// Convert C++ Variable to a Python type following a compiled plan, without setting an error if it is impossible
+Object try_plan_cast(Variable &&v, CastPlan const &p, Object const &root) {
+    DUMP("try_plan_cast ", v.type(), " of qualifier ", v.qualifier(), " step ", int(p.step));
+    switch (p.step) {
+        case CastPlan::none:       return {Py_None, true};
+        case CastPlan::boolean:    return bool_cast(std::move(v));
+        case CastPlan::integer:    return int_cast(std::move(v));
+        case CastPlan::real:       return float_cast(std::move(v));
+        case CastPlan::str:        return str_cast(std::move(v));
+        case CastPlan::bytes:      return bytes_cast(std::move(v));
+        case CastPlan::deduced:    return as_deduced_object(std::move(v));
+        case CastPlan::variable:   return variable_cast(std::move(v), root, p.target);
+        case CastPlan::type_index: return type_index_cast(std::move(v));
+        case CastPlan::function:   return function_cast(std::move(v));
+        case CastPlan::memoryview: return memoryview_cast(std::move(v), root);
+        case CastPlan::typed: {
+            auto const &t = cast_object<TypeIndex>(p.target);
+            Dispatch msg;
+            if (auto var = std::move(v).request_variable(msg, t))
+                return variable_cast(std::move(var), root);
+            std::string c1 = v.type().name(), c2 = t.name();
+            return type_error("could not convert object of type %s to type %s", c1.data(), c2.data());
+        }
+        case CastPlan::list:       return list_cast(std::move(v), p, root);
+        case CastPlan::tuple:
+        case CastPlan::tuple_of:   return tuple_cast(std::move(v), p, root);
+        case CastPlan::dict:
+        case CastPlan::str_dict:   return dict_cast(std::move(v), p, root);
+        case CastPlan::union_of:   return union_cast(std::move(v), p, root);
+        case CastPlan::conversion: {
+            DUMP(" conversion ");
+            Object o = variable_cast(std::move(v), root);
+            if (!o) return type_error("could not cast Variable to Python object");
+            DUMP("calling function");
+            return Object::from(PyObject_CallFunctionObjArgs(+p.target, +o, nullptr));
+        }
+        case CastPlan::unknown:    return nullptr;
+    }
     return nullptr;
 }
 
-Object python_cast(Variable &&v, Object const &t, Object root) {
-    Object out = try_python_cast(std::move(v), t, std::move(root));
-    if (!out) return type_error("cannot convert value to type %R from type %S", +t, +type_index_cast(v.type()));
+Object plan_cast(Variable &&v, CastPlan const &p, Object const &root) {
+    Object out = try_plan_cast(std::move(v), p, root);
+    if (!out && PyErr_Occurred()) return {}; // keep the error from a nested cast
+    if (!out) return type_error("cannot convert value to type %R from type %S", +p.type, +type_index_cast(v.type()));
     return out;
 }
 
 /******************************************************************************/
 
+/// Maximum number of compiled annotations, beyond which the cache is emptied
+#ifndef REBIND_CAST_PLAN_CACHE
+#   define REBIND_CAST_PLAN_CACHE 1024
+#endif
+
+/// Compiled plans keyed by annotation identity. Plans are shared so that one stays valid while a
+/// cast which is following it runs Python code which invalidates the cache.
+/// The map is never destroyed, since its references must not be released after Python is finalized
+auto &cast_plans = *new std::unordered_map<Object, std::shared_ptr<CastPlan const>>;
+
+void clear_cast_plans() noexcept {cast_plans.clear();}
+
+std::shared_ptr<CastPlan const> cast_plan(Object const &t) {
+    if (auto it = cast_plans.find(t); it != cast_plans.end()) return it->second;
+    auto p = std::make_shared<CastPlan const>(compile_cast(t, t));
+    if (cast_if<TypeIndex>(t)) return p; // instances rather than annotations, so not worth keeping
+    if (cast_plans.size() >= REBIND_CAST_PLAN_CACHE) cast_plans.clear();
+    cast_plans.emplace(t, p);
+    return p;
+}
+
+Object python_cast(Variable &&v, Object const &t, Object root) {
+    auto const plan = cast_plan(t);
+    return plan_cast(std::move(v), *plan, root);
+}
+
+/******************************************************************************/
+
 }
@@ -2,18 +2,58 @@ namespace rebind {
 
 /******************************************************************************/
 
-Object call_overload(ErasedFunction const &fun, Sequence args, bool gil) {
+/// Diagnostics of an overload which did not accept the arguments
+struct Failure {
+    Trial status;
+    Mismatch mismatch;
+    std::string message; // set instead if the overload body threw a DispatchError
+    Object source_type; // keeps the Python type described by the mismatch alive until the message is built
+
+    Object object() const {
+        if (!message.empty()) return as_object(std::string_view(message));
+        if (status == Trial::wrong_number)
+            return Object::from(PyUnicode_FromFormat("C++: wrong number of arguments (expected %u, got %u)",
+                static_cast<unsigned int>(mismatch.expected), static_cast<unsigned int>(mismatch.received)));
+        return as_object(wrong_type_message(mismatch));
+    }
+};
+
+/// Record the diagnostics of an overload. A Python type described as the source is referenced rather than
+/// described, so that its description is only built if every overload fails. Must be called with the GIL held
+void record_failure(Vector<Failure> &failures, Trial status, Mismatch m) {
+    Object type;
+    if (auto t = described_python_type(m.source)) type = {t, true};
+    else m.describe_source();
+    failures.push_back({status, std::move(m), {}, std::move(type)});
+}
+
+/******************************************************************************/
+
+/// Call an overload. If the arguments do not match, either throw, or if failures is given,
+/// append the diagnostics to it and return a null Object without setting a Python error
+Object call_overload(ErasedFunction const &fun, Sequence &args, bool gil, Vector<Failure> *failures=nullptr) {
     // if (auto py = fun.target<PythonFunction>())
     //     return {PyObject_CallObject(+py->function, +args), false};
     DUMP("constructed python args, number = ", args.size());
     for (auto const &p : args) DUMP(p.type());
     Variable out;
+    Trial status;
+    std::optional<Mismatch> mismatch;
     {
-        auto lk = std::make_shared<PythonFrame>(!gil);
-        Caller ct(lk);
+        Arena arena; // requests no memory unless a heap held payload is made
+        AllocatorScope scope(CallArena ? &arena : current_allocator());
+        PythonFrameScope frame(!gil);
+        Caller ct = frame.caller();
+        Dispatch msg(ct);
         DUMP("calling the args: size=", args.size());
-        out = fun(ct, std::move(args));
+        status = fun.trial(out, ct, args, msg);
+        if (status == Trial::wrong_number && !failures)
+            throw WrongNumber(msg.expected, msg.received);
+        if (status == Trial::wrong_type && !failures)
+            throw std::move(msg).exception();
+        if (status != Trial::ok) mismatch = msg.mismatch();
     }
+    if (mismatch) return record_failure(*failures, status, std::move(*mismatch)), Object(); // the GIL is held again
     DUMP("got the output ", out.type());
     if (auto p = out.target<Object const &>()) return *p;
     // if (auto p = out.target<PyObject * &>()) return {*p, true};
@@ -23,141 +63,309 @@ Object call_overload(ErasedFunction const &fun, Sequence args, bool gil) {
 
 /******************************************************************************/
 
-Object function_call_impl(Function const &fun, Sequence args, PyObject *sig, TypeIndex const &t0, TypeIndex const &t1, bool gil) {
+Object function_call_impl(Function &fun, Sequence args, PyObject *sig, TypeIndex const &t0, TypeIndex const &t1, bool gil) {
     auto const &overloads = fun.overloads;
 
-    if (overloads.size() == 1) // only 1 overload
+    if (overloads.size() == 1) // only 1 overload, so there is no order to keep
         return call_overload(overloads[0].second, args, gil);
 
     if (sig && PyLong_Check(sig)) { // signature given as an integer index
         auto i = PyLong_AsLongLong(sig);
         if (i < 0) i += overloads.size();
-        if (i <= overloads.size() || i < 0)
-            return call_overload(overloads[i].second, std::move(args), gil);
+        if (0 <= i && i < static_cast<long long>(overloads.size())) {
+            auto out = call_overload(overloads[i].second, args, gil);
+            if (out) fun.index.record(i);
+            return out;
+        }
         PyErr_SetString(PyExc_IndexError, "signature index out of bounds");
         return Object();
     }
 
-    auto errors = Object::from(PyList_New(0));
-
-    //  Check for equivalence on the first argument first -- provides short-circuiting for methods
-    for (auto const exact : {true, false}) {
-        for (auto const &o : overloads) {
-            bool const match = (o.first.size() < 2) || (!args.empty() && args[0].type().matches(o.first[1]));
-            if (match != exact) continue;
-            if (sig) { // check the explicit signature that was passed in
-                if (PyTuple_Check(sig)) {
-                    auto const len = PyObject_Length(sig);
-                    if (len > o.first.size())
-                        return type_error("C++: too many types given in signature");
-                    for (Py_ssize_t i = 0; i != len; ++i) {
-                        PyObject *x = PyTuple_GET_ITEM(sig, i);
-                        if (x != Py_None && !cast_object<TypeIndex>(x).matches(o.first[i])) continue;
-                    }
-                } else return type_error("C++: expected 'signature' to be a tuple");
-            } else {
-                if (t0 && o.first.size() > 0 && !o.first[0].matches(t0)) continue; // check that the return type matches if specified
-                if (t1 && o.first.size() > 1 && !o.first[1].matches(t1)) continue; // check that the first argument type matches if specified
-            }
+    Vector<Failure> failures;
+    // Call overload i, returning its output, or a null Object after recording its failure (or setting a Python error)
+    auto attempt = [&](unsigned int i) -> Object {
+        try {
+            auto out = call_overload(overloads[i].second, args, gil, &failures);
+            if (out) fun.index.record(i);
+            return out;
+        } catch (WrongType const &e) { // thrown from within the overload body
+            record_failure(failures, Trial::wrong_type, e);
+        } catch (WrongNumber const &e) {
+            failures.push_back({Trial::wrong_number, {}, {}});
+            failures.back().mismatch.expected = e.expected;
+            failures.back().mismatch.received = e.received;
+        } catch (DispatchError const &e) {
+            failures.push_back({Trial::wrong_type, {}, e.what()});
+        }
+        return {};
+    };
 
-            try {
-                return call_overload(o.second, args, gil);
-            } catch (WrongType const &e) {
-                if (PyList_Append(+errors, +as_object(wrong_type_message(e)))) return {};
-            } catch (WrongNumber const &e) {
-                unsigned int n0 = e.expected, n = e.received;
-                auto s = Object::from(PyUnicode_FromFormat("C++: wrong number of arguments (expected %u, got %u)", n0, n));
-                if (PyList_Append(+errors, +s)) return {};
-            } catch (DispatchError const &e) {
-                if (PyList_Append(+errors, +as_object(std::string_view(e.what())))) return {};
-            }
+    // copied, since a reentrant call or another thread may reorder the index while an overload runs
+    SmallVector<unsigned int, 8> candidates;
+    for (auto const c : fun.index.candidates(args.size(), args.empty() ? nullptr : &args[0].type().info()))
+        candidates.emplace_back(c);
+    for (auto const c : candidates) {
+        auto const &o = overloads[c];
+        if (sig) { // check the explicit signature that was passed in
+            if (PyTuple_Check(sig)) {
+                auto const len = PyObject_Length(sig);
+                if (len > o.first.size())
+                    return type_error("C++: too many types given in signature");
+                for (Py_ssize_t i = 0; i != len; ++i) {
+                    PyObject *x = PyTuple_GET_ITEM(sig, i);
+                    if (x != Py_None && !cast_object<TypeIndex>(x).matches(o.first[i])) continue;
+                }
+            } else return type_error("C++: expected 'signature' to be a tuple");
+        } else {
+            if (t0 && o.first.size() > 0 && !o.first[0].matches(t0)) continue; // check that the return type matches if specified
+            if (t1 && o.first.size() > 1 && !o.first[1].matches(t1)) continue; // check that the first argument type matches if specified
         }
+        if (auto out = attempt(c)) return out;
+        if (PyErr_Occurred()) return {};
+    }
+    // Overloads skipped by the index did not accept the number of arguments
+    for (unsigned int i = 0; i != overloads.size(); ++i) {
+        auto const &k = fun.index.key(i);
+        if (k.min_args <= args.size() && args.size() <= k.max_args) continue;
+        failures.push_back({Trial::wrong_number, {}, {}});
+        failures.back().mismatch.expected = args.size() < k.min_args ? k.min_args : k.max_args;
+        failures.back().mismatch.received = args.size();
     }
     // Raise an exception with a list of the messages
+    auto errors = Object::from(PyList_New(0));
+    for (auto const &f : failures)
+        if (PyList_Append(+errors, +f.object())) return {};
     return PyErr_SetObject(TypeError, +errors), nullptr;
 }
 
 /******************************************************************************/
 
-auto function_call_keywords(PyObject *kws) {
-    bool gil = true;
+/// Return if a keyword name equals an interned string, comparing by identity first
+bool keyword_is(PyObject *name, PyObject *interned) noexcept {
+    return name == interned || PyUnicode_Compare(name, interned) == 0;
+}
+
+/// Keywords of a Function call; others are ignored
+struct CallKeywords {
     TypeIndex t0, t1;
-    PyObject *sig=nullptr;
+    PyObject *sig = nullptr;
+    bool gil = true;
+
+    /// Return whether name is one of the keywords
+    bool set(PyObject *name, PyObject *value) {
+        static PyObject * const gil_name = PyUnicode_InternFromString("gil"),
+            * const signature_name = PyUnicode_InternFromString("signature"),
+            * const return_name = PyUnicode_InternFromString("return_type"),
+            * const first_name = PyUnicode_InternFromString("first_type");
+        if (keyword_is(name, gil_name)) gil = PyObject_IsTrue(value);
+        else if (keyword_is(name, signature_name)) sig = not_none(value); // either int or Tuple[TypeIndex] or None
+        else if (keyword_is(name, return_name)) {if (not_none(value)) t0 = cast_object<TypeIndex>(value);} // either TypeIndex or None
+        else if (keyword_is(name, first_name)) {if (not_none(value)) t1 = cast_object<TypeIndex>(value);} // either TypeIndex or None
+        else return false;
+        return true;
+    }
+};
+
+CallKeywords function_call_keywords(PyObject *kws) {
+    CallKeywords k;
     if (kws && PyDict_Check(kws)) {
-        PyObject *g = PyDict_GetItemString(kws, "gil");
-        if (g) gil = PyObject_IsTrue(g);
-        sig = not_none(PyDict_GetItemString(kws, "signature")); // either int or Tuple[TypeIndex] or None
-        auto r = not_none(PyDict_GetItemString(kws, "return_type")); // either TypeIndex or None
-        auto f = not_none(PyDict_GetItemString(kws, "first_type")); // either TypeIndex or None
-        // std::cout << PyObject_Length(kws) << bool(g) << bool(sig) << bool(f) << bool(r) << std::endl;
-        // if (PyObject_Length(kws) != unsigned(bool(g)) + (sig || r || f))
-            // return type_error("C++: unexpected extra keywords");
-        if (r) t0 = cast_object<TypeIndex>(r);
-        if (f) t1 = cast_object<TypeIndex>(f);
+        PyObject *name, *value;
+        for (Py_ssize_t pos = 0; PyDict_Next(kws, &pos, &name, &value);) k.set(name, value);
     }
-    return std::make_tuple(t0, t1, sig, gil);
+    return k;
+}
+
+/// Read the keywords of a vectorcall: names in kwnames and values following the positional arguments
+CallKeywords function_call_keywords(PyObject *const *values, PyObject *kwnames) {
+    CallKeywords k;
+    if (kwnames)
+        for (Py_ssize_t i = 0; i != PyTuple_GET_SIZE(kwnames); ++i) k.set(PyTuple_GET_ITEM(kwnames, i), values[i]);
+    return k;
 }
 
 /******************************************************************************/
 
+/// Function with named parameters, defaults and annotations, which binds its keyword arguments natively
 struct AnnotatedFunction {
-    struct Annotation {
-        std::string name;
-        std::vector<Object> callback;
-        Object type;
+    struct Argument {
+        Object name; //< interned str
+        Object value; //< default Python object, or null
+        Variable constant; //< default C++ value declared with the Function, or empty
+        Object callback; //< argument types of a Callable annotation, or null
     };
-    Function function;
-    std::string format;
-    std::vector<Annotation> annotations;
-    std::size_t max_positional=0;
-    Object return_type;
+    Object function; //< the rebind.Function
+    Vector<Argument> arguments;
+    Object return_type; //< null if not annotated
+    Object dict; //< attributes, e.g. from functools.update_wrapper
+    bool variadic = false; //< if no parameters are known, pass all positional arguments through
+
+    template <class K>
+    Object operator()(PyObject *const *args, std::size_t n, K const &for_each_keyword) const;
+
+    static PyObject *call(PyObject *self, PyObject *args, PyObject *kws) noexcept;
+    static PyObject *get(PyObject *self, PyObject *object, PyObject *type) noexcept;
+    static PyObject *make(PyObject *self, PyObject *args) noexcept;
+#if REBIND_VECTORCALL
+    static PyObject *vectorcall(PyObject *self, PyObject *const *args, std::size_t nargsf, PyObject *kwnames) noexcept;
+#endif
 };
 
-struct AnnotatedMethod {
-    AnnotatedFunction function;
-    Object self;
-};// args, then parse keywords
-
-PyObject *function_annotated_impl(PyObject *data, PyObject *args, PyObject *kws) noexcept {
-    return raw_object([=]() -> Object {
-        auto const &v = *cast_object<Variable>(data).target<AnnotatedFunction const &>();
-        if (PyTuple_GET_SIZE(args) > v.max_positional) return nullptr;
-        std::vector<PyObject *> args;
-        std::vector<char const *> names;
-        // PyArg_VaParseTupleAndKeywords(args, kws, v.format.data(), va_list); with defaults
-
-        std::vector<Variable> arguments;
-        for (auto const &p : v.annotations) {
-            arguments.emplace_back(); // make_callback = make function that wraps it but casts to the given argument types
+template <>
+struct Holder<AnnotatedFunction> : CallableHolder<AnnotatedFunction> {};
+
+/// Raise a TypeError like the one Python raises for a mismatched call
+template <class ...Ts>
+PythonError binding_error(char const *s, Ts ...ts) {
+    PyErr_Format(PyExc_TypeError, s, ts...);
+    return python_error();
+}
+
+/// Bind positional arguments, then keywords by name, then defaults, and call the Function.
+/// for_each_keyword(f) should call f(name, value) for each keyword argument
+template <class K>
+Object AnnotatedFunction::operator()(PyObject *const *args, std::size_t n, K const &for_each_keyword) const {
+    CallKeywords k;
+    Sequence v;
+    if (variadic) {
+        for_each_keyword([&](PyObject *name, PyObject *value) {
+            if (!k.set(name, value)) throw binding_error("unexpected keyword argument %R", name);
+        });
+        args_from_python(v, args, n);
+    } else {
+        auto const m = arguments.size();
+        if (n > m) throw binding_error("too many positional arguments (expected at most %zu, got %zu)", m, n);
+        SmallVector<PyObject *, 8> slots;
+        for (std::size_t i = 0; i != m; ++i) slots.emplace_back(i < n ? args[i] : nullptr);
+        for_each_keyword([&](PyObject *name, PyObject *value) {
+            auto it = std::find_if(arguments.begin(), arguments.end(), [=](auto const &a) {return keyword_is(name, +a.name);});
+            if (it == arguments.end()) {
+                if (!k.set(name, value)) throw binding_error("unexpected keyword argument %R", name);
+            } else if (auto &slot = slots[it - arguments.begin()]) {
+                throw binding_error("multiple values for argument %R", name);
+            } else slot = value;
+        });
+        v.reserve(m);
+        for (std::size_t i = 0; i != m; ++i) {
+            auto const &a = arguments[i];
+            if (auto x = slots[i]) {
+                if (a.callback && PyCallable_Check(x)) { // the callback casts its arguments to the annotated types
+                    Function f;
+                    f.emplace(PythonFunction({x, true}, a.callback), {});
+                    v.emplace_back(std::move(f));
+                } else v.emplace_back(variable_reference_from_object({x, true}));
+            }
+            else if (a.value) v.emplace_back(variable_reference_from_object(a.value));
+            else if (a.constant) v.emplace_back(a.constant.reference()); // shared, so only by const reference
+            else throw binding_error("missing required argument %R", +a.name);
         }
-        Variable out;// = function(arguments);
+    }
 
-        if (!v.return_type) return variable_cast(std::move(out)); // no cast
-        else if (v.return_type == Py_None || +v.return_type == reinterpret_cast<PyObject const *>(Py_None->ob_type)) return {Py_None, true}; // cast to None
-        else return python_cast(std::move(out), v.return_type, Object());
+    auto out = function_call_impl(cast_object<Function>(function), std::move(v), k.sig, k.t0, k.t1, k.gil);
+    if (!out || !return_type) return out; // no cast
+    if (+return_type == Py_None || +return_type == reinterpret_cast<PyObject *>(Py_None->ob_type))
+        return {Py_None, true}; // return None regardless of output
+    if (+out == Py_None)
+        throw binding_error("Expected %R but was returned object None", +return_type);
+    if (auto p = cast_if<Variable>(out)) return python_cast(std::move(*p), return_type, out);
+    return out;
+}
+
+PyObject *AnnotatedFunction::call(PyObject *self, PyObject *args, PyObject *kws) noexcept {
+    return raw_object([=] {
+        return cast_object<AnnotatedFunction>(self)(PySequence_Fast_ITEMS(args), PyTuple_GET_SIZE(args), [=](auto &&f) {
+            PyObject *name, *value;
+            if (kws) for (Py_ssize_t pos = 0; PyDict_Next(kws, &pos, &name, &value);) f(name, value);
+        });
     });
 }
 
-// take Function, argument names, argument defaults, annotations, # keyword arguments, return_type
-// return function which casts arguments into correct types and order and calls self with the resultant *args
-PyMethodDef function_annotated_ml = {"annotated",
-    reinterpret_cast<PyCFunction>(&function_annotated_impl),
-    METH_VARARGS|METH_KEYWORDS,
-    "annotated(a, b)\nannotated function wrapper"
-};
+#if REBIND_VECTORCALL
+PyObject *AnnotatedFunction::vectorcall(PyObject *self, PyObject *const *args, std::size_t nargsf, PyObject *kwnames) noexcept {
+    return raw_object([=] {
+        auto const n = PyVectorcall_NARGS(nargsf);
+        return cast_object<AnnotatedFunction>(self)(args, n, [=](auto &&f) {
+            if (kwnames) for (Py_ssize_t i = 0; i != PyTuple_GET_SIZE(kwnames); ++i) f(PyTuple_GET_ITEM(kwnames, i), args[n + i]);
+        });
+    });
+}
+#endif
 
-PyObject *function_annotated(PyObject *self, PyObject *args) noexcept {
+/// Bind to an instance like a Python function does
+PyObject *AnnotatedFunction::get(PyObject *self, PyObject *object, PyObject *) noexcept {
+    if (!object) return incref(self), self;
+    return PyMethod_New(self, object);
+}
+
+/// Return an interned copy of a str
+Object interned(Object s) {
+    if (!PyUnicode_Check(+s)) throw python_error(type_error("expected str but got %R", (+s)->ob_type));
+    PyObject *p = s.ptr;
+    s.ptr = nullptr;
+    PyUnicode_InternInPlace(&p);
+    return {p, false};
+}
+
+/* Function.annotated has the following signature:
+ * () -> use the parameters declared in C++, if any
+ * (names, defaults, callbacks, return_type, empty) -> the parameters of a placeholder, where
+ * defaults are given for each parameter (or empty if required), callbacks are None or the argument
+ * types of a Callable annotation, and return_type may be empty if not annotated
+ */
+PyObject *AnnotatedFunction::make(PyObject *self, PyObject *args) noexcept {
     return raw_object([=] {
+        PyObject *names = nullptr, *defaults = nullptr, *callbacks = nullptr, *ret = nullptr, *empty = nullptr;
+        if (!PyArg_ParseTuple(args, "|OOOOO", &names, &defaults, &callbacks, &ret, &empty)) return Object();
         AnnotatedFunction a;
-        a.function = cast_object<Function>(self);
-        // std::cout << function_annotated_ml.ml_name << function_annotated_ml.ml_doc << std::endl;
-        return Object::from(PyCFunction_New(&function_annotated_ml, variable_cast(std::move(a))));
-        // auto c = _PyType_GetTextSignatureFromInternalDoc(function_annotated_ml.ml_name, function_annotated_ml.ml_doc);
-        // if (c) print(c);
-        // return o;
+        a.function = {self, true};
+        if (!names) {
+            auto const &f = cast_object<Function>(self);
+            a.variadic = f.parameters.empty();
+            for (auto const &p : f.parameters)
+                a.arguments.push_back({Object::from(PyUnicode_InternFromString(p.name.c_str())), {}, p.value, {}});
+            return default_object(std::move(a));
+        }
+        if (!empty) return type_error("C++: expected 0 or 5 arguments to annotated()"), Object();
+        auto const n = PyObject_Length(names);
+        if (n < 0) return Object();
+        if (PyObject_Length(defaults) != n || PyObject_Length(callbacks) != n)
+            return type_error("C++: expected the same number of names, defaults and callbacks"), Object();
+        for (Py_ssize_t i = 0; i != n; ++i) {
+            auto d = Object::from(PySequence_GetItem(defaults, i));
+            auto c = Object::from(PySequence_GetItem(callbacks, i));
+            if (+c != Py_None && !PyTuple_Check(+c))
+                return type_error("C++: expected tuple or None but got %R", (+c)->ob_type), Object();
+            a.arguments.push_back({interned(Object::from(PySequence_GetItem(names, i))),
+                +d == empty ? Object() : std::move(d), {}, +c == Py_None ? Object() : std::move(c)});
+        }
+        if (ret != empty) a.return_type = {ret, true};
+        return default_object(std::move(a));
     });
 }
 
+PyObject *annotated_function(PyObject *self, void *) noexcept {
+    return incref(+cast_object<AnnotatedFunction>(self).function), +cast_object<AnnotatedFunction>(self).function;
+}
+
+PyGetSetDef AnnotatedFunctionGetSet[] = {
+    {const_cast<char *>("__dict__"), PyObject_GenericGetDict, PyObject_GenericSetDict, nullptr, nullptr},
+    {const_cast<char *>("function"), annotated_function, nullptr, const_cast<char *>("the wrapped rebind.Function"), nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr}
+};
+
+template <>
+PyTypeObject CallableHolder<AnnotatedFunction>::type = []{
+    auto t = type_definition<AnnotatedFunction>("rebind.AnnotatedFunction", "C++ function with named parameters and annotations");
+    t.tp_call = AnnotatedFunction::call;
+    t.tp_descr_get = AnnotatedFunction::get;
+    t.tp_getset = AnnotatedFunctionGetSet;
+    t.tp_dictoffset = offsetof(Holder<AnnotatedFunction>, value) + offsetof(AnnotatedFunction, dict);
+#if REBIND_VECTORCALL
+    CallableHolder<AnnotatedFunction>::entry = AnnotatedFunction::vectorcall;
+    t.tp_flags |= Py_TPFLAGS_METHOD_DESCRIPTOR; // binding is equivalent to passing the instance first
+#endif
+    return t;
+}();
+
 /******************************************************************************/
 
 struct DelegatingMethod {
@@ -175,12 +383,54 @@ struct DelegatingMethod {
             return Object::from(PyObject_Call(s.wrapping, args2, kws2));
         });
     };
+
+#if REBIND_VECTORCALL
+    static PyObject *vectorcall(PyObject *self, PyObject *const *args, std::size_t nargsf, PyObject *kwnames) noexcept;
+#endif
 };
 
 template <>
-PyTypeObject Holder<DelegatingMethod>::type = []{
+struct Holder<DelegatingMethod> : CallableHolder<DelegatingMethod> {};
+
+#if REBIND_VECTORCALL
+
+/// Call wrapping with self (if given), the positional and keyword arguments, and the keyword _fun_=function
+PyObject *delegate_vectorcall(PyObject *wrapping, PyObject *function, PyObject *self,
+                              PyObject *const *args, std::size_t nargsf, PyObject *kwnames) noexcept {
+    return raw_object([=] {
+        static PyObject * const fun_names = Py_BuildValue("(s)", "_fun_");
+        auto const n = PyVectorcall_NARGS(nargsf);
+        auto const nk = kwnames ? PyTuple_GET_SIZE(kwnames) : 0;
+        SmallVector<PyObject *, 8> all;
+        all.emplace_back(nullptr); // spare slot, so the callee may prepend an argument in place
+        if (self) all.emplace_back(self);
+        for (Py_ssize_t i = 0; i != n + nk; ++i) all.emplace_back(args[i]);
+        all.emplace_back(function);
+        Object names{fun_names, true};
+        if (nk) {
+            names = Object::from(PyTuple_New(nk + 1));
+            for (Py_ssize_t i = 0; i != nk; ++i) if (!set_tuple_item(names, i, PyTuple_GET_ITEM(kwnames, i))) return Object();
+            if (!set_tuple_item(names, nk, PyTuple_GET_ITEM(fun_names, 0))) return Object();
+        }
+        return Object::from(PyObject_Vectorcall(wrapping, all.begin() + 1,
+            (n + bool(self)) | PY_VECTORCALL_ARGUMENTS_OFFSET, +names));
+    });
+}
+
+PyObject *DelegatingMethod::vectorcall(PyObject *self, PyObject *const *args, std::size_t nargsf, PyObject *kwnames) noexcept {
+    auto const &s = reinterpret_cast<Holder<DelegatingMethod> *>(self)->value;
+    return delegate_vectorcall(+s.wrapping, +s.function, +s.captured_self, args, nargsf, kwnames);
+}
+
+#endif
+
+template <>
+PyTypeObject CallableHolder<DelegatingMethod>::type = []{
     auto t = type_definition<DelegatingMethod>("rebind.DelegatingMethod", "C++ delegating method");
     t.tp_call = DelegatingMethod::call;
+#if REBIND_VECTORCALL
+    CallableHolder<DelegatingMethod>::entry = DelegatingMethod::vectorcall;
+#endif
     return t;
 }();
 
@@ -212,30 +462,48 @@ struct DelegatingFunction {
     static PyObject *make(PyObject *self, PyObject *old) noexcept {
         return raw_object([=] {return default_object(DelegatingFunction{{self, true}, {old, true}});});
     }
+
+#if REBIND_VECTORCALL
+    static PyObject *vectorcall(PyObject *self, PyObject *const *args, std::size_t nargsf, PyObject *kwnames) noexcept;
+#endif
 };
 
 template <>
-PyTypeObject Holder<DelegatingFunction>::type = []{
+struct Holder<DelegatingFunction> : CallableHolder<DelegatingFunction> {};
+
+#if REBIND_VECTORCALL
+PyObject *DelegatingFunction::vectorcall(PyObject *self, PyObject *const *args, std::size_t nargsf, PyObject *kwnames) noexcept {
+    auto const &s = reinterpret_cast<Holder<DelegatingFunction> *>(self)->value;
+    return delegate_vectorcall(+s.wrapping, +s.function, nullptr, args, nargsf, kwnames);
+}
+#endif
+
+template <>
+PyTypeObject CallableHolder<DelegatingFunction>::type = []{
     auto t = type_definition<DelegatingFunction>("rebind.DelegatingFunction", "C++ delegating function");
     t.tp_call = DelegatingFunction::call;
     t.tp_descr_get = DelegatingFunction::get;
+#if REBIND_VECTORCALL
+    CallableHolder<DelegatingFunction>::entry = DelegatingFunction::vectorcall;
+    t.tp_flags |= Py_TPFLAGS_METHOD_DESCRIPTOR; // binding is equivalent to passing the instance first
+#endif
     return t;
 }();
 
 /******************************************************************************/
 
 struct Method {
-    Function fun;
+    Object fun; // the rebind.Function, whose OverloadIndex is shared by every bound Method
     Object self;
 
     static PyObject *call(PyObject *self, PyObject *pyargs, PyObject *kws) noexcept {
         return raw_object([=] {
             auto const &s = cast_object<Method>(self);
-            auto [t0, t1, sig, gil] = function_call_keywords(kws);
+            auto const k = function_call_keywords(kws);
             Sequence args;
             args.emplace_back(variable_reference_from_object(s.self));
             args_from_python(args, {pyargs, true});
-            return function_call_impl(s.fun, std::move(args), sig, t0, t1, gil);
+            return function_call_impl(cast_object<Function>(s.fun), std::move(args), k.sig, k.t0, k.t1, k.gil);
         });
     }
 
@@ -243,15 +511,40 @@ struct Method {
         return raw_object([=]() -> Object {
             if (!object) return {self, true};
             // capture bound object
-            return default_object(Method{cast_object<Function>(self), {object, true}});
+            return default_object(Method{{self, true}, {object, true}});
         });
     }
+
+#if REBIND_VECTORCALL
+    static PyObject *vectorcall(PyObject *self, PyObject *const *args, std::size_t nargsf, PyObject *kwnames) noexcept;
+#endif
 };
 
 template <>
-PyTypeObject Holder<Method>::type = []{
+struct Holder<Method> : CallableHolder<Method> {};
+
+#if REBIND_VECTORCALL
+PyObject *Method::vectorcall(PyObject *self, PyObject *const *args, std::size_t nargsf, PyObject *kwnames) noexcept {
+    return raw_object([=] {
+        auto const &s = cast_object<Method>(self);
+        auto const n = PyVectorcall_NARGS(nargsf);
+        auto const k = function_call_keywords(args + n, kwnames);
+        Sequence v;
+        v.reserve(n + 1);
+        v.emplace_back(variable_reference_from_object(s.self));
+        args_from_python(v, args, n);
+        return function_call_impl(cast_object<Function>(s.fun), std::move(v), k.sig, k.t0, k.t1, k.gil);
+    });
+}
+#endif
+
+template <>
+PyTypeObject CallableHolder<Method>::type = []{
     auto o = type_definition<Method>("rebind.Method", "Bound method");
     o.tp_call = Method::call;
+#if REBIND_VECTORCALL
+    CallableHolder<Method>::entry = Method::vectorcall;
+#endif
     return o;
 }();
 
@@ -266,15 +559,28 @@ PyTypeObject Holder<Method>::type = []{
  */
 PyObject * function_call(PyObject *self, PyObject *pyargs, PyObject *kws) noexcept {
     return raw_object([=] {
-        auto const [t0, t1, sig, gil] = function_call_keywords(kws);
-        DUMP("specified return and first types ", bool(t0), " ", bool(t1));
-        DUMP("gil = ", gil, " ", Py_REFCNT(self), Py_REFCNT(pyargs));
+        auto const k = function_call_keywords(kws);
+        DUMP("specified return and first types ", bool(k.t0), " ", bool(k.t1));
+        DUMP("gil = ", k.gil, " ", Py_REFCNT(self), Py_REFCNT(pyargs));
         DUMP("number of signatures ", cast_object<Function>(self).overloads.size());
         Sequence args;
         args_from_python(args, {pyargs, true});
-        return function_call_impl(cast_object<Function>(self), std::move(args), sig, t0, t1, gil);
+        return function_call_impl(cast_object<Function>(self), std::move(args), k.sig, k.t0, k.t1, k.gil);
+    });
+}
+
+#if REBIND_VECTORCALL
+/// Same as function_call(), reading the arguments straight from the vectorcall array
+PyObject * function_vectorcall(PyObject *self, PyObject *const *args, std::size_t nargsf, PyObject *kwnames) noexcept {
+    return raw_object([=] {
+        auto const n = PyVectorcall_NARGS(nargsf);
+        auto const k = function_call_keywords(args + n, kwnames);
+        Sequence v;
+        args_from_python(v, args, n);
+        return function_call_impl(cast_object<Function>(self), std::move(v), k.sig, k.t0, k.t1, k.gil);
     });
 }
+#endif
 
 /******************************************************************************/
 
@@ -287,6 +593,28 @@ PyObject * function_signatures(PyObject *self, PyObject *) noexcept {
     });
 }
 
+PyObject * function_hits(PyObject *self, PyObject *) noexcept {
+    return raw_object([=] {
+        return map_as_tuple(cast_object<Function>(self).index.counts(), [](std::size_t n) {
+            return Object::from(PyLong_FromSize_t(n));
+        });
+    });
+}
+
+PyObject * function_parameters(PyObject *self, PyObject *) noexcept {
+    return raw_object([=] {
+        return map_as_tuple(cast_object<Function>(self).parameters, [](auto const &p) {return as_object(p.name);});
+    });
+}
+
+PyObject * function_reorder(PyObject *self, PyObject *) noexcept {
+    return raw_object([=] {
+        auto &f = cast_object<Function>(self);
+        f.index.reorder();
+        return Object(Py_None, true);
+    });
+}
+
 /******************************************************************************/
 
 int function_init(PyObject *self, PyObject *args, PyObject *kws) noexcept {
@@ -312,20 +640,27 @@ PyMethodDef FunctionTypeMethods[] = {
     // {"move_from", static_cast<PyCFunction>(move_from<Function>),   METH_VARARGS, "move it"},
     {"copy_from",   static_cast<PyCFunction>(copy_from<Function>), METH_O,       "copy from another Function"},
     {"signatures",  static_cast<PyCFunction>(function_signatures), METH_NOARGS,  "get signatures"},
+    {"hits",        static_cast<PyCFunction>(function_hits),       METH_NOARGS,  "get the number of calls accepted by each overload, in the order of signatures()"},
+    {"reorder",     static_cast<PyCFunction>(function_reorder),    METH_NOARGS,  "try the overloads which accepted the most calls first"},
     {"delegating",  static_cast<PyCFunction>(DelegatingFunction::make), METH_O,  "delegating(self, other): return an equivalent of partial(other, _fun_=self)"},
-    {"annotated",   static_cast<PyCFunction>(function_annotated),  METH_VARARGS, "annotated(self, annotations): return a function wrapping self which casts inputs and output to the given type annotations"},
+    {"annotated",   static_cast<PyCFunction>(AnnotatedFunction::make), METH_VARARGS, "annotated(self, names, defaults, callbacks, return_type, empty): return a function wrapping self which binds keywords and casts inputs and output to the given type annotations"},
+    {"parameters",  static_cast<PyCFunction>(function_parameters), METH_NOARGS,  "get the names of the parameters declared in C++"},
     {nullptr, nullptr, 0, nullptr}
 };
 
 /******************************************************************************/
 
 template <>
-PyTypeObject Holder<Function>::type = []{
+PyTypeObject CallableHolder<Function>::type = []{
     auto o = type_definition<Function>("rebind.Function", "C++function object");
     o.tp_init = function_init;
     o.tp_call = function_call;
     o.tp_methods = FunctionTypeMethods;
     o.tp_descr_get = Method::make;
+#if REBIND_VECTORCALL
+    CallableHolder<Function>::entry = function_vectorcall;
+    o.tp_flags |= Py_TPFLAGS_METHOD_DESCRIPTOR; // binding is equivalent to passing the instance first
+#endif
     return o;
 }();
 
@@ -8,6 +8,8 @@ std::unordered_map<Object, Object> type_translations{}, output_conversions{}, in
 
 std::unordered_map<std::type_index, Object> python_types{};
 
+bool CallArena = false;
+
 
 void initialize_global_objects() {
     TypeError = {PyExc_TypeError, true};
@@ -21,6 +23,7 @@ void clear_global_objects() {
     input_conversions.clear();
     output_conversions.clear();
     type_translations.clear();
+    clear_cast_plans();
     python_types.clear();
     UnionType = nullptr;
     TypeError = nullptr;
@@ -39,6 +42,7 @@ std::unordered_map<TypeIndex, std::string> type_names = {
     {typeid(Binary),           "Binary"},
     {typeid(BinaryData),       "BinaryData"},
     {typeid(ArrayView),        "ArrayView"},
+    {typeid(SharedArray),      "SharedArray"},
     {typeid(Function),         "Function"},
     {typeid(Variable),         "Variable"},
     {typeid(Sequence),         "Sequence"},
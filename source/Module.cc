@@ -33,30 +33,75 @@ namespace rebind {
 
 /******************************************************************************/
 
+/// Contiguous copy of a strided array, for a consumer which asked for a contiguous buffer
+struct ArrayCopy {
+    std::vector<Py_ssize_t> strides;
+    std::unique_ptr<char[]> data;
+};
+
+/// Order of the contiguous buffer requested by flags, as accepted by PyBuffer_IsContiguous, or 0 if any strides are accepted
+char requested_order(int flags) noexcept {
+    if ((flags & PyBUF_STRIDES) != PyBUF_STRIDES) return 'C'; // no strides are given to the consumer
+    if ((flags & PyBUF_C_CONTIGUOUS) == PyBUF_C_CONTIGUOUS) return 'C';
+    if ((flags & PyBUF_F_CONTIGUOUS) == PyBUF_F_CONTIGUOUS) return 'F';
+    if ((flags & PyBUF_ANY_CONTIGUOUS) == PyBUF_ANY_CONTIGUOUS) return 'A';
+    return 0;
+}
+
 int array_data_buffer(PyObject *self, Py_buffer *view, int flags) noexcept {
     auto p = cast_if<ArrayBuffer>(self);
     if (!p) return 1;
+    if ((flags & PyBUF_WRITABLE) && !p->mutate) {
+        PyErr_SetString(PyExc_BufferError, "C++: array is not writable");
+        return view->obj = nullptr, -1;
+    }
     view->buf = p->data;
 
     view->itemsize = Buffer::itemsize(*p->type);
-    view->len = p->n_elem;
+    view->len = p->layout.n_elem() * view->itemsize;
     view->readonly = !p->mutate;
     view->format = const_cast<char *>(Buffer::format(*p->type).data());
-    view->ndim = p->shape_stride.size() / 2;
+    view->ndim = p->layout.depth();
     view->shape = p->shape_stride.data();
     view->strides = p->shape_stride.data() + view->ndim;
     view->suboffsets = nullptr;
+    view->internal = nullptr;
+
+    // a consumer which cannot follow the strides is lent a contiguous copy, which it must not write to
+    if (auto const order = requested_order(flags); order && !PyBuffer_IsContiguous(view, order)) {
+        if (flags & PyBUF_WRITABLE) {
+            PyErr_SetString(PyExc_BufferError, "C++: array is not contiguous");
+            return view->obj = nullptr, -1;
+        }
+        try {
+            auto copy = std::make_unique<ArrayCopy>();
+            copy->data.reset(new char[view->len]);
+            auto const to = copy_contiguous(copy->data.get(), p->data, p->layout, view->itemsize, order == 'F');
+            for (std::size_t i = 0; i != to.depth(); ++i) copy->strides.emplace_back(to.stride(i) * view->itemsize);
+            view->buf = copy->data.get();
+            view->strides = copy->strides.data();
+            view->readonly = 1;
+            view->internal = copy.release();
+        } catch (std::bad_alloc const &) {
+            return view->obj = nullptr, PyErr_NoMemory(), -1;
+        }
+    }
+    if (!(flags & PyBUF_FORMAT)) view->format = nullptr;
+    if (!(flags & PyBUF_ND)) view->shape = nullptr;
+    if ((flags & PyBUF_STRIDES) != PyBUF_STRIDES) view->strides = nullptr;
     view->obj = self;
     ++p->exports;
+    if (auto v = cast_if<Var>(p->base)) ++v->exports; // the data may belong to the Variable
     DUMP("allocating new array buffer", bool(p->base));
     incref(view->obj);
     return 0;
 }
 
 void array_data_release(PyObject *self, Py_buffer *view) noexcept {
-    // auto &p  = cast_object<ArrayBuffer>(self)
-    // --p.exports;
-    // if (p.exports)
+    auto &p = cast_object<ArrayBuffer>(self);
+    --p.exports;
+    if (auto v = cast_if<Var>(p.base)) --v->exports;
+    delete static_cast<ArrayCopy *>(view->internal);
     DUMP("releasing array buffer");
 }
 
@@ -139,6 +184,7 @@ Object initialize(Document const &doc) {
         && attach_type(m, "DelegatingFunction", type_object<DelegatingFunction>())
         && attach_type(m, "DelegatingMethod", type_object<DelegatingMethod>())
         && attach_type(m, "Method", type_object<Method>())
+        && attach_type(m, "AnnotatedFunction", type_object<AnnotatedFunction>())
             // Tuple[Tuple[int, TypeIndex, int], ...]
         && attach(m, "scalars", map_as_tuple(scalars, [](auto const &x) {
             return args_as_tuple(as_object(static_cast<Integer>(std::get<0>(x))),
@@ -159,16 +205,30 @@ Object initialize(Document const &doc) {
         }))
         && attach(m, "set_output_conversion", as_object(Function::of([](Object t, Object o) {
             output_conversions.insert_or_assign(std::move(t), std::move(o));
+            clear_cast_plans();
         })))
         && attach(m, "set_input_conversion", as_object(Function::of([](Object t, Object o) {
             input_conversions.insert_or_assign(std::move(t), std::move(o));
         })))
         && attach(m, "set_translation", as_object(Function::of([](Object t, Object o) {
             type_translations.insert_or_assign(std::move(t), std::move(o));
+            clear_cast_plans();
         })))
         && attach(m, "clear_global_objects", as_object(Function::of(&clear_global_objects)))
         && attach(m, "set_debug", as_object(Function::of([](bool b) {return std::exchange(Debug, b);})))
         && attach(m, "debug", as_object(Function::of([] {return Debug;})))
+        && attach(m, "set_call_arena", as_object(Function::of([](bool b) {return std::exchange(CallArena, b);})))
+        && attach(m, "call_arena", as_object(Function::of([] {return CallArena;})))
+        && attach(m, "set_array_narrowing", as_object(Function::of([](bool b) {return std::exchange(ArrayNarrowing, b);})))
+        && attach(m, "array_narrowing", as_object(Function::of([] {return ArrayNarrowing;})))
+        && attach(m, "allocation_counters", as_object(Function::of([] {
+            auto o = Object::from(PyDict_New());
+            for (auto const &p : {std::make_pair("heap", &allocation_counters.heap),
+                                  std::make_pair("absorbed", &allocation_counters.absorbed),
+                                  std::make_pair("chunks", &allocation_counters.chunks)})
+                if (PyDict_SetItemString(+o, p.first, +as_object(static_cast<Integer>(p.second->load())))) return Object();
+            return o;
+        })))
         && attach(m, "set_type_error", as_object(Function::of([](Object o) {TypeError = std::move(o);})))
         && attach(m, "set_type", as_object(Function::of([](TypeIndex idx, Object o) {
             DUMP("set_type in");
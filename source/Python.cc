@@ -5,6 +5,9 @@
 #include <rebind-python/API.h>
 #include <rebind/Document.h>
 #include <complex>
+#include <cmath>
+#include <limits>
+#include <cstring>
 #include <any>
 #include <iostream>
 
@@ -84,28 +87,293 @@ std::string_view from_bytes(PyObject *o) {
 
 /******************************************************************************/
 
-template <class T>
-bool to_arithmetic(Object const &o, Variable &v) {
-    DUMP("cast arithmetic in: ", v.type());
-    if (PyFloat_Check(o)) return v = static_cast<T>(PyFloat_AsDouble(+o)), true;
-    if (PyLong_Check(o)) return v = static_cast<T>(PyLong_AsLongLong(+o)), true;
-    if (PyBool_Check(o)) return v = static_cast<T>(+o == Py_True), true;
-    if (PyNumber_Check(+o)) { // This can be hit for e.g. numpy.int64
-        if (std::is_integral_v<T>) {
-            if (auto i = Object::from(PyNumber_Long(+o)))
-                return v = static_cast<T>(PyLong_AsLongLong(+i)), true;
+/// Truncate a Python float to integral type T, failing if it is out of range.
+/// These conversions assign to v, which may be a Variable or a T
+template <class T, class V>
+bool truncated_response(double x, V &v) {
+    double const t = std::trunc(x), hi = std::ldexp(1.0, std::numeric_limits<T>::digits);
+    if (!(t >= (std::is_signed_v<T> ? -hi : 0.0) && t < hi)) return false; // also rejects NaN
+    return v = static_cast<T>(t), true;
+}
+
+/// Convert arithmetic value s to arithmetic type T, failing if T is integral and s is out of its range
+template <class T, class S, class V>
+bool narrowed_response(S s, V &v) {
+    if constexpr(!std::is_integral_v<T> || std::is_same_v<T, bool>) {
+        return v = static_cast<T>(s), true;
+    } else if constexpr(std::is_floating_point_v<S>) {
+        return truncated_response<T>(static_cast<double>(s), v);
+    } else {
+        if constexpr(std::is_signed_v<S>) if (s < 0) {
+            if (!std::is_signed_v<T> || static_cast<long long>(s) < static_cast<long long>(std::numeric_limits<T>::min())) return false;
+            return v = static_cast<T>(s), true;
+        }
+        if (static_cast<unsigned long long>(s) > static_cast<unsigned long long>(std::numeric_limits<T>::max())) return false;
+        return v = static_cast<T>(s), true;
+    }
+}
+
+/// Convert a Python int to integral type T, failing if it is out of range
+template <class T, class V>
+bool integer_response(PyObject *o, V &v) {
+    int overflow = 0;
+    long long const i = PyLong_AsLongLongAndOverflow(o, &overflow);
+    if (i == -1 && PyErr_Occurred()) return PyErr_Clear(), false;
+    if (overflow < 0) return false;
+    if (overflow == 0) return narrowed_response<T>(i, v);
+    unsigned long long const u = PyLong_AsUnsignedLongLong(o); // e.g. for unsigned long long
+    if (u == static_cast<unsigned long long>(-1) && PyErr_Occurred()) return PyErr_Clear(), false;
+    return narrowed_response<T>(u, v);
+}
+
+/******************************************************************************/
+
+/// Return the format character of a single native scalar, or 0
+inline char scalar_format(char const *f) noexcept {
+    if (!f) return 'B';
+    if (*f == '@' || *f == '=' || *f == (PY_LITTLE_ENDIAN ? '<' : '>')) ++f; // native byte order
+    return f[0] && !f[1] ? f[0] : 0;
+}
+
+/// Read a native scalar with the given format character and size as arithmetic type T
+template <class T, class V>
+bool scalar_response(char format, Py_ssize_t itemsize, void const *p, V &v) {
+    auto read = [&](auto s) {
+        if (itemsize != sizeof(s)) return false;
+        std::memcpy(&s, p, sizeof(s));
+        return narrowed_response<T>(s, v);
+    };
+    switch (format) {
+        case 'd': return read(double());
+        case 'f': return read(float());
+        case 'g': return read(static_cast<long double>(0));
+        case '?': return read(bool());
+        case 'b': return read(static_cast<signed char>(0));
+        case 'B': return read(static_cast<unsigned char>(0));
+        case 'h': return read(short());
+        case 'H': return read(static_cast<unsigned short>(0));
+        case 'i': return read(int());
+        case 'I': return read(0u);
+        case 'l': return read(0l);
+        case 'L': return read(0ul);
+        case 'q': return read(0ll);
+        case 'Q': return read(0ull);
+        case 'n': return read(static_cast<Py_ssize_t>(0));
+        case 'N': return read(std::size_t());
+        default: return false;
+    }
+}
+
+/// Read the value of a 0-dimensional buffer as arithmetic type T
+template <class T, class V>
+bool buffer_response(PyObject *o, V &v) {
+    Buffer buff(o, PyBUF_RECORDS_RO);
+    if (!buff) return PyErr_Clear(), false;
+    if (buff.view.ndim != 0) return false;
+    return scalar_response<T>(scalar_format(buff.view.format), buff.view.itemsize, buff.view.buf, v);
+}
+
+/******************************************************************************/
+
+/// Where a number type which exports a 0-dimensional buffer (e.g. numpy.float32) keeps its value
+struct ScalarLayout {
+    PyTypeObject *type;
+    Py_ssize_t offset = -1; //< offset of the value within each instance, or -1 if it is not held inline
+    Py_ssize_t itemsize = 0;
+    char format = 0;
+};
+
+/// Return whether t is a numpy number or bool scalar type. Such instances are immutable and export their value
+/// from within themselves with the same format; other buffer exporters may point elsewhere or change
+bool numpy_scalar_type(PyTypeObject *t) {
+    static PyObject *number = nullptr, *boolean = nullptr; // never released
+    if (!number) {
+        // a numpy type only exists once numpy is imported, so it is looked up rather than imported
+        PyObject *numpy = PyDict_GetItemString(PyImport_GetModuleDict(), "numpy");
+        if (!numpy) return false;
+        Object n(PyObject_GetAttrString(numpy, "number"), false), b(PyObject_GetAttrString(numpy, "bool_"), false);
+        if (!n || !b || !PyType_Check(+n) || !PyType_Check(+b)) return PyErr_Clear(), false;
+        number = std::exchange(n.ptr, nullptr), boolean = std::exchange(b.ptr, nullptr);
+    }
+    return PyType_IsSubtype(t, reinterpret_cast<PyTypeObject *>(number))
+        || PyType_IsSubtype(t, reinterpret_cast<PyTypeObject *>(boolean));
+}
+
+/// Return the layout of the type of o, learned from the buffer exported by the first instance seen.
+/// The value is only read in place later for a numpy scalar type whose buffer pointed inside the (fixed size) instance
+ScalarLayout const &scalar_layout(PyObject *o) {
+    static auto &layouts = *new std::vector<ScalarLayout>; // never released, as each type is referenced
+    auto const t = o->ob_type;
+    for (auto const &l : layouts) if (l.type == t) return l;
+    ScalarLayout l{t};
+    if (t->tp_itemsize == 0 && t->tp_as_buffer && t->tp_as_buffer->bf_getbuffer && numpy_scalar_type(t)) {
+        if (Buffer buff{o, PyBUF_RECORDS_RO}) {
+            auto const &view = buff.view;
+            auto const offset = static_cast<char const *>(view.buf) - reinterpret_cast<char const *>(o);
+            if (view.ndim == 0 && offset >= static_cast<Py_ssize_t>(sizeof(PyObject))
+                && offset + view.itemsize <= t->tp_basicsize)
+                l.offset = offset, l.itemsize = view.itemsize, l.format = scalar_format(view.format);
+        } else PyErr_Clear();
+    }
+    incref(reinterpret_cast<PyObject *>(t)); // so that the address is not reused by another type
+    layouts.push_back(l);
+    return layouts.back();
+}
+
+/// Call a slot which should return an instance of type, or return null without an error set
+inline Object number_slot(unaryfunc f, PyObject *o, PyTypeObject *type) {
+    if (!f) return {};
+    Object out(f(o), false);
+    if (!out || !PyObject_TypeCheck(+out, type)) return PyErr_Clear(), Object();
+    return out;
+}
+
+/// Convert a Python number to arithmetic type T in one step; integers are range checked
+template <class T, class V>
+bool to_arithmetic(PyObject *o, V &v) {
+    DUMP("cast arithmetic in: ", typeid(T).name());
+    if constexpr(std::is_same_v<T, bool> || std::is_floating_point_v<T>) {
+        if (PyFloat_Check(o)) return v = static_cast<T>(PyFloat_AsDouble(o)), true;
+        if (PyBool_Check(o)) return v = static_cast<T>(o == Py_True), true;
+        if (PyLong_Check(o)) {
+            double const x = PyLong_AsDouble(o);
+            if (x == -1.0 && PyErr_Occurred()) return PyErr_Clear(), false;
+            return v = static_cast<T>(x), true;
+        }
+    } else {
+        if (PyLong_Check(o)) return integer_response<T>(o, v); // includes bool
+        if (PyFloat_Check(o)) return truncated_response<T>(PyFloat_AsDouble(o), v);
+    }
+    // Other scalars, e.g. numpy.int64: read the value in place if possible, else call the number slots of
+    // the type directly, else read a 0-dimensional buffer, e.g. of a ctypes scalar
+    auto const type = o->ob_type;
+    if (auto n = type->tp_as_number) {
+        if (n->nb_index || n->nb_float) { // numpy scalars hold their value inline and are read in place
+            auto const &l = scalar_layout(o);
+            if (l.offset >= 0 && scalar_response<T>(l.format, l.itemsize, reinterpret_cast<char const *>(o) + l.offset, v))
+                return true; // otherwise e.g. float16 has no C++ equivalent
+        }
+        if constexpr(std::is_integral_v<T>) {
+            if (auto i = number_slot(n->nb_index, o, &PyLong_Type)) return to_arithmetic<T>(+i, v);
+            if (auto i = number_slot(n->nb_int, o, &PyLong_Type)) return to_arithmetic<T>(+i, v);
+            if (auto x = number_slot(n->nb_float, o, &PyFloat_Type)) return to_arithmetic<T>(+x, v);
         } else {
-            if (auto i = Object::from(PyNumber_Float(+o)))
-               return v = static_cast<T>(PyFloat_AsDouble(+i)), true;
+            if (auto x = number_slot(n->nb_float, o, &PyFloat_Type)) return to_arithmetic<T>(+x, v);
+            if (auto i = number_slot(n->nb_index, o, &PyLong_Type)) return to_arithmetic<T>(+i, v);
         }
     }
-    DUMP("cast arithmetic out: ", v.type());
-    return false;
+    DUMP("cast arithmetic out: ", typeid(T).name());
+    return type->tp_as_buffer && type->tp_as_buffer->bf_getbuffer && buffer_response<T>(o, v);
+}
+
+using DirectResponse = bool (*)(PyObject *, Variable &);
+
+/// Direct conversions of Python numbers to each arithmetic type
+std::pair<std::type_info const *, DirectResponse> const arithmetic_responses[] = {
+    {&typeid(Integer), to_arithmetic<Integer>}, {&typeid(Real), to_arithmetic<Real>},
+    {&typeid(int), to_arithmetic<int>}, {&typeid(unsigned int), to_arithmetic<unsigned int>},
+    {&typeid(float), to_arithmetic<float>}, {&typeid(bool), to_arithmetic<bool>},
+    {&typeid(long), to_arithmetic<long>}, {&typeid(unsigned long), to_arithmetic<unsigned long>},
+    {&typeid(long long), to_arithmetic<long long>}, {&typeid(unsigned long long), to_arithmetic<unsigned long long>},
+    {&typeid(short), to_arithmetic<short>}, {&typeid(unsigned short), to_arithmetic<unsigned short>},
+    {&typeid(signed char), to_arithmetic<signed char>}, {&typeid(unsigned char), to_arithmetic<unsigned char>},
+    {&typeid(char), to_arithmetic<char>}, {&typeid(wchar_t), to_arithmetic<wchar_t>},
+    {&typeid(char16_t), to_arithmetic<char16_t>}, {&typeid(char32_t), to_arithmetic<char32_t>},
+    {&typeid(double), to_arithmetic<double>}, {&typeid(long double), to_arithmetic<long double>}
+};
+
+/******************************************************************************/
+
+/// Convert an item of a list or tuple to T without making a Variable
+template <class T>
+bool item_response(PyObject *o, T &t) {
+    if constexpr(std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>) {
+        if (PyUnicode_Check(o)) return t = T(from_unicode(o)), true;
+        if (PyBytes_Check(o)) return t = T(from_bytes(o)), true;
+        return false;
+    } else {
+        if constexpr(std::is_same_v<T, bool>) if (o == Py_None) return t = false, true;
+        return to_arithmetic<T>(o, t);
+    }
+}
+
+/// Convert a list or tuple to std::vector<T> in one pass over its items. If any item does not
+/// convert, fail without an error so that the element-wise request reports which one it was
+template <class T>
+bool vector_response(PyObject *o, Variable &v) {
+    std::vector<T> out;
+    out.reserve(PySequence_Fast_GET_SIZE(o));
+    // the size is re-read since the number slots of an item might modify a list
+    for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(o); ++i) {
+        Object const item(PySequence_Fast_GET_ITEM(o, i), true);
+        T t{};
+        if (!item_response(+item, t)) return false;
+        out.emplace_back(std::move(t));
+    }
+    return v.emplace(Type<std::vector<T>>(), std::move(out)), true;
 }
 
+/// Direct conversions of Python lists and tuples to vectors of primitive types
+std::pair<std::type_info const *, DirectResponse> const vector_responses[] = {
+    {&typeid(std::vector<Integer>), vector_response<Integer>}, {&typeid(std::vector<Real>), vector_response<Real>},
+    {&typeid(std::vector<int>), vector_response<int>}, {&typeid(std::vector<unsigned int>), vector_response<unsigned int>},
+    {&typeid(std::vector<float>), vector_response<float>}, {&typeid(std::vector<bool>), vector_response<bool>},
+    {&typeid(std::vector<long>), vector_response<long>}, {&typeid(std::vector<unsigned long>), vector_response<unsigned long>},
+    {&typeid(std::vector<long long>), vector_response<long long>}, {&typeid(std::vector<unsigned long long>), vector_response<unsigned long long>},
+    {&typeid(std::vector<short>), vector_response<short>}, {&typeid(std::vector<unsigned short>), vector_response<unsigned short>},
+    {&typeid(std::vector<signed char>), vector_response<signed char>}, {&typeid(std::vector<unsigned char>), vector_response<unsigned char>},
+    {&typeid(std::vector<char>), vector_response<char>}, {&typeid(std::vector<long double>), vector_response<long double>},
+    {&typeid(std::vector<std::string>), vector_response<std::string>}, {&typeid(std::vector<std::string_view>), vector_response<std::string_view>}
+};
+
 /******************************************************************************/
 
+/// View of the contents of a buffer, which is only valid while the buffer is held.
+/// Fails if a stride is not a whole number of items, which the layout cannot represent
+std::optional<ArrayView> buffer_view(Buffer const &buff) {
+    // Read in the shape and strides but ignore suboffsets
+    DUMP("making data");
+    DUMP(Buffer::format(buff.view.format ? buff.view.format : "").name());
+    DUMP("ndim", buff.view.ndim);
+    DUMP((nullptr == buff.view.buf), bool(buff.view.readonly));
+    for (auto i = 0; i != buff.view.ndim; ++i) DUMP(i, buff.view.shape[i], buff.view.strides[i]);
+    DUMP("itemsize", buff.view.itemsize);
+    ArrayLayout lay;
+    lay.contents.reserve(buff.view.ndim);
+    for (std::size_t i = 0; i != buff.view.ndim; ++i) {
+        if (buff.view.strides[i] % buff.view.itemsize) return {};
+        lay.contents.emplace_back(buff.view.shape[i], buff.view.strides[i] / buff.view.itemsize);
+    }
+    DUMP("layout", lay);
+    DUMP("depth", lay.depth());
+    ArrayData data{buff.view.buf, buff.view.format ? &Buffer::format(buff.view.format) : &typeid(void), !buff.view.readonly};
+    return ArrayView(std::move(data), std::move(lay));
+}
+
+/// Keep a buffer and its exporter alive until the last copy of the array is destroyed.
+/// The buffer may be released from any thread, so the GIL is taken to do so
+std::optional<SharedArray> shared_array(Buffer &&buff) {
+    auto view = buffer_view(buff);
+    if (!view) return {};
+    std::shared_ptr<Buffer const> owner(new Buffer(std::move(buff)), [](Buffer const *b) {
+        if (!Py_IsInitialized()) return; // leak rather than touch a finalized interpreter
+        auto const state = PyGILState_Ensure();
+        delete b;
+        PyGILState_Release(state);
+    });
+    return SharedArray(std::move(*view), std::move(owner));
+}
+
 bool object_response(Variable &v, TypeIndex t, Object o) {
+    if (t.equals<SharedArray>() && PyObject_CheckBuffer(+o)) {
+        // checked first since a Variable owning an array exports it (and is not mutable until it is released)
+        if (auto buff = Buffer(o, PyBUF_FULL_RO)) {
+            if (auto a = shared_array(std::move(buff))) return v.emplace(Type<SharedArray>(), std::move(*a)), true;
+            return false;
+        }
+        PyErr_Clear();
+    }
+
     if (Debug) {
         auto repr = Object::from(PyObject_Repr(SubClass<PyTypeObject>{(+o)->ob_type}));
         DUMP("input object reference count ", reference_count(o));
@@ -120,6 +388,15 @@ bool object_response(Variable &v, TypeIndex t, Object o) {
         return v.has_value();
     }
 
+    if (t.qualifier() == Value) {
+        for (auto const &p : arithmetic_responses) if (&t.info() == p.first) {
+            if (p.first == &typeid(bool) && +o == Py_None) return v = false, true;
+            return p.second(+o, v);
+        }
+        if (PyList_Check(o) || PyTuple_Check(o))
+            for (auto const &p : vector_responses) if (&t.info() == p.first) return p.second(+o, v);
+    }
+
     if (t.matches<TypeIndex>()) {
         if (auto p = cast_if<TypeIndex>(o)) return v = *p, true;
         else return false;
@@ -149,18 +426,6 @@ bool object_response(Variable &v, TypeIndex t, Object o) {
         } else return false;
     }
 
-    if (t.equals<Real>())
-        return to_arithmetic<Real>(o, v);
-
-    if (t.equals<Integer>())
-        return to_arithmetic<Integer>(o, v);
-
-    if (t.equals<bool>()) {
-        if ((+o)->ob_type == Py_None->ob_type) { // fix, doesnt work with Py_None...
-            return v = false, true;
-        } else return to_arithmetic<bool>(o, v);
-    }
-
     if (t.equals<std::string_view>()) {
         if (PyUnicode_Check(+o)) return v.emplace(Type<std::string_view>(), from_unicode(+o)), true;
         if (PyBytes_Check(+o)) return v.emplace(Type<std::string_view>(), from_bytes(+o)), true;
@@ -175,23 +440,10 @@ bool object_response(Variable &v, TypeIndex t, Object o) {
 
     if (t.equals<ArrayView>()) {
         if (PyObject_CheckBuffer(+o)) {
-            // Read in the shape but ignore strides, suboffsets
             DUMP("cast buffer", reference_count(o));
             if (auto buff = Buffer(o, PyBUF_FULL_RO)) {
-                DUMP("making data", reference_count(o));
-                DUMP(Buffer::format(buff.view.format ? buff.view.format : "").name());
-                DUMP("ndim", buff.view.ndim);
-                DUMP((nullptr == buff.view.buf), bool(buff.view.readonly));
-                for (auto i = 0; i != buff.view.ndim; ++i) DUMP(i, buff.view.shape[i], buff.view.strides[i]);
-                DUMP("itemsize", buff.view.itemsize);
-                ArrayLayout lay;
-                lay.contents.reserve(buff.view.ndim);
-                for (std::size_t i = 0; i != buff.view.ndim; ++i)
-                    lay.contents.emplace_back(buff.view.shape[i], buff.view.strides[i] / buff.view.itemsize);
-                DUMP("layout", lay, reference_count(o));
-                DUMP("depth", lay.depth());
-                ArrayData data{buff.view.buf, buff.view.format ? &Buffer::format(buff.view.format) : &typeid(void), !buff.view.readonly};
-                return v.emplace(Type<ArrayView>(), std::move(data), std::move(lay)), true;
+                if (auto a = buffer_view(buff)) return v.emplace(Type<ArrayView>(), std::move(*a)), true;
+                return false;
             } else throw python_error(type_error("C++: could not get buffer"));
         } else return false;
     }
@@ -218,11 +470,28 @@ std::string get_type_name(TypeIndex idx) noexcept {
 
 /******************************************************************************/
 
-std::string wrong_type_message(WrongType const &e, std::string_view prefix) {
+namespace {
+    std::string python_type_name(void const *t) {
+        if (auto o = Object(PyObject_Repr(const_cast<PyObject *>(static_cast<PyObject const *>(t))), false))
+            return std::string(from_unicode(o));
+        PyErr_Clear();
+        return "<unknown Python type>";
+    }
+}
+
+Description describe_python_type(PyObject *type) noexcept {return {nullptr, type, python_type_name};}
+
+PyObject *described_python_type(Description const &d) noexcept {
+    return d.describe == python_type_name ? const_cast<PyObject *>(static_cast<PyObject const *>(d.object)) : nullptr;
+}
+
+/******************************************************************************/
+
+std::string wrong_type_message(Mismatch const &e, std::string_view prefix) {
     std::ostringstream os;
-    os << prefix << e.what() << " (#" << e.index << ", ";
-    if (!e.source.empty())
-        os << e.source << " \u2192 " << get_type_name(e.dest) << ", ";
+    os << prefix << e.scope << " (#" << e.index << ", ";
+    if (e.has_source())
+        os << e.source_str() << " \u2192 " << get_type_name(e.dest) << ", ";
     if (!e.indices.empty()) {
         auto it = e.indices.begin();
         os << "scopes=[" << *it;
@@ -242,10 +511,10 @@ std::string wrong_type_message(WrongType const &e, std::string_view prefix) {
 Variable variable_reference_from_object(Object o) {
     if (auto p = cast_if<Function>(o)) return {Type<Function const &>(), *p};
     else if (auto p = cast_if<std::type_index>(o)) return {Type<std::type_index>(), *p};
-    else if (auto p = cast_if<Variable>(o)) {
+    else if (auto p = cast_if<Var>(o)) {
         DUMP("variable from object ", p, " ", p->data());
-        DUMP("variable qualifier=", p->qualifier(), ", reference qualifier=", p->reference().qualifier());
-        return p->reference();
+        DUMP("variable qualifier=", p->qualifier(), ", exports=", p->exports);
+        return p->lend();
     }
     else return std::move(o);
 }
@@ -258,6 +527,66 @@ void args_from_python(Sequence &v, Object const &args) {
     map_iterable(args, [&v](Object o) {v.emplace_back(variable_reference_from_object(std::move(o)));});
 }
 
+// Store the objects in an argument array in pack
+void args_from_python(Sequence &v, PyObject *const *args, std::size_t n) {
+    v.reserve(v.size() + n);
+    for (std::size_t i = 0; i != n; ++i) v.emplace_back(variable_reference_from_object({args[i], true}));
+}
+
+/******************************************************************************/
+
+namespace {
+
+/// Frames left by exited threads, for use by any thread
+std::mutex frame_reserve_mutex;
+std::vector<PythonFrame *> frame_reserve;
+
+struct FramePool {
+    std::vector<PythonFrame *> frames;
+
+    PythonFrame *take() {
+        if (!frames.empty()) {
+            auto f = frames.back();
+            frames.pop_back();
+            return f;
+        }
+        std::lock_guard<std::mutex> lk(frame_reserve_mutex);
+        if (frame_reserve.empty()) return new PythonFrame;
+        auto f = frame_reserve.back();
+        frame_reserve.pop_back();
+        return f;
+    }
+
+    ~FramePool() {
+        std::lock_guard<std::mutex> lk(frame_reserve_mutex);
+        frame_reserve.insert(frame_reserve.end(), frames.begin(), frames.end());
+    }
+};
+
+thread_local FramePool frame_pool;
+
+}
+
+PythonFrameScope::PythonFrameScope(bool no_gil) : frame(frame_pool.take()) {
+    frame->no_gil.store(no_gil, std::memory_order_release);
+}
+
+PythonFrameScope::~PythonFrameScope() {
+    // only the owning thread advances the generation, so no read-modify-write is needed
+    auto const next = frame->generation.load(std::memory_order_relaxed) + 1;
+    PyThreadState *state = nullptr;
+    if (frame->no_gil.load(std::memory_order_relaxed)) {
+        // wait for a thread calling back into Python through this frame; once the generation is advanced
+        // under the mutex, no other thread uses the state
+        std::lock_guard<std::mutex> lk(frame->mutex);
+        state = std::exchange(frame->state, nullptr);
+        frame->generation.store(next, std::memory_order_release);
+    } else frame->generation.store(next, std::memory_order_release);
+    if (state) PyEval_RestoreThread(state);
+    try {frame_pool.frames.push_back(frame);}
+    catch (...) {} // the frame is leaked rather than freed, as expired Callers may still refer to it
+}
+
 /******************************************************************************/
 
 }
@@ -1,4 +1,11 @@
 #include <rebind/Document.h>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
 
 /******************************************************************************/
 
@@ -50,6 +57,82 @@ bool debug() noexcept {return Debug;}
 
 /******************************************************************************/
 
+AllocationCounters allocation_counters;
+
+namespace {
+    thread_local Allocator *installed_allocator = nullptr;
+
+    /// Stored immediately before each heap held payload placed by an Allocator
+    struct PayloadHeader {
+        void (*release)(void *, void *) noexcept;
+        void *owner;
+    };
+
+    /// Distance from the start of the memory to the payload; a multiple of a since a is a power of 2
+    constexpr std::size_t placed_offset(std::size_t a) noexcept {
+        return a > sizeof(PayloadHeader) ? a : sizeof(PayloadHeader);
+    }
+}
+
+Allocator *current_allocator() noexcept {return installed_allocator;}
+
+AllocatorScope::AllocatorScope(Allocator *a) noexcept : previous(std::exchange(installed_allocator, a)) {}
+
+AllocatorScope::~AllocatorScope() {installed_allocator = previous;}
+
+void *allocate_placed(std::size_t n, std::size_t a) {
+    if (!installed_allocator) return nullptr;
+    std::size_t const off = placed_offset(a);
+    Allocation const m = installed_allocator->allocate(off + n, std::max(a, alignof(PayloadHeader)));
+    if (!m.memory) return ++allocation_counters.heap, nullptr;
+    ++allocation_counters.absorbed;
+    auto p = static_cast<char *>(m.memory) + off;
+    ::new(p - sizeof(PayloadHeader)) PayloadHeader{m.release, m.owner};
+    return p;
+}
+
+void deallocate_placed(void *p, std::size_t a) noexcept {
+    auto h = reinterpret_cast<PayloadHeader *>(static_cast<char *>(p) - sizeof(PayloadHeader));
+    h->release(h->owner, static_cast<char *>(p) - placed_offset(a));
+}
+
+/******************************************************************************/
+
+/// Chunk header, followed by the chunk memory; counts the Arena and each live payload
+struct Arena::Chunk {
+    std::atomic<std::size_t> count{1};
+
+    std::uintptr_t begin() const noexcept {return reinterpret_cast<std::uintptr_t>(this + 1);}
+
+    static void release(void *owner, void *) noexcept {
+        auto c = static_cast<Chunk *>(owner);
+        if (c->count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            c->~Chunk();
+            ::operator delete(c);
+        }
+    }
+};
+
+Allocation Arena::allocate(std::size_t n, std::size_t a) {
+    if (n > size / 4) return {}; // leave large payloads to the global heap
+    auto const align = [a](std::uintptr_t x) {return (x + a - 1) & ~std::uintptr_t(a - 1);};
+    std::uintptr_t p = chunk ? align(chunk->begin() + offset) : 0;
+    if (!chunk || p + n > chunk->begin() + size) {
+        if (chunk) Chunk::release(std::exchange(chunk, nullptr), nullptr);
+        chunk = ::new(::operator new(sizeof(Chunk) + size)) Chunk();
+        ++allocation_counters.chunks;
+        p = align(chunk->begin());
+        if (p + n > chunk->begin() + size) return {};
+    }
+    offset = p + n - chunk->begin();
+    chunk->count.fetch_add(1, std::memory_order_relaxed);
+    return {reinterpret_cast<void *>(p), Chunk::release, chunk};
+}
+
+Arena::~Arena() {if (chunk) Chunk::release(chunk, nullptr);}
+
+/******************************************************************************/
+
 Document & document() noexcept {
     static Document static_document;
     return static_document;
@@ -61,6 +144,237 @@ void render_default(Document &, std::type_info const &t) {
 
 /******************************************************************************/
 
+namespace {
+
+/// One dimension of a strided copy, with strides in bytes
+struct CopyDimension {
+    std::size_t shape;
+    std::ptrdiff_t to, from;
+};
+
+/// Copy n items of N bytes; the constant size lets memcpy become a single load and store
+template <std::size_t N>
+void copy_items(char *o, std::ptrdiff_t to, char const *s, std::ptrdiff_t from, std::size_t n, std::size_t) noexcept {
+    for (; n; --n, o += to, s += from) std::memcpy(o, s, N);
+}
+
+void copy_items(char *o, std::ptrdiff_t to, char const *s, std::ptrdiff_t from, std::size_t n, std::size_t item) noexcept {
+    for (; n; --n, o += to, s += from) std::memcpy(o, s, item);
+}
+
+using ItemCopy = void (*)(char *, std::ptrdiff_t, char const *, std::ptrdiff_t, std::size_t, std::size_t) noexcept;
+
+ItemCopy item_copy(std::size_t item) noexcept {
+    switch (item) {
+        case 1: return copy_items<1>;
+        case 2: return copy_items<2>;
+        case 4: return copy_items<4>;
+        case 8: return copy_items<8>;
+        case 16: return copy_items<16>;
+        default: return copy_items;
+    }
+}
+
+/// Loop over the outer dimensions d[0, depth - 1) and copy along the innermost one
+void copy_dimensions(char *o, char const *s, CopyDimension const *d, std::size_t depth, std::size_t item, ItemCopy copy) noexcept {
+    if (depth == 1) {
+        if (d->to == static_cast<std::ptrdiff_t>(item) && d->from == d->to) std::memcpy(o, s, d->shape * item);
+        else copy(o, d->to, s, d->from, d->shape, item);
+    } else for (std::size_t i = 0; i != d->shape; ++i, o += d->to, s += d->from)
+        copy_dimensions(o, s, d + 1, depth - 1, item, copy);
+}
+
+}
+
+void copy_array(void *out, ArrayLayout const &to, void const *data, ArrayLayout const &from, std::size_t itemsize) {
+    if (to.depth() != from.depth()) throw std::invalid_argument("copy_array() layouts have different depths");
+    auto const item = static_cast<std::ptrdiff_t>(itemsize);
+    Vector<CopyDimension> dims;
+    dims.reserve(to.depth());
+    for (std::size_t i = 0; i != to.depth(); ++i) {
+        if (to.shape(i) != from.shape(i)) throw std::invalid_argument("copy_array() layouts have different shapes");
+        if (to.shape(i) == 0) return;
+        if (to.shape(i) != 1) dims.push_back({to.shape(i), to.stride(i) * item, from.stride(i) * item});
+    }
+    if (to.depth() == 0) return; // no elements, as in ArrayLayout::n_elem()
+    if (dims.empty()) return std::memcpy(out, data, itemsize), void();
+    // the innermost loop runs along the smallest destination stride, so that the output is written in order
+    std::stable_sort(dims.begin(), dims.end(), [](auto const &a, auto const &b) {return std::abs(a.to) > std::abs(b.to);});
+    // merge each dimension into the next inner one when the pair is contiguous in both layouts
+    auto inner = dims.end() - 1;
+    for (auto d = inner; d != dims.begin();) {
+        --d;
+        if (d->to == inner->to * static_cast<std::ptrdiff_t>(inner->shape)
+            && d->from == inner->from * static_cast<std::ptrdiff_t>(inner->shape)) {
+            inner->shape *= d->shape;
+        } else *--inner = *d;
+    }
+    copy_dimensions(static_cast<char *>(out), static_cast<char const *>(data), &*inner,
+                    dims.end() - inner, itemsize, item_copy(itemsize));
+}
+
+ArrayLayout copy_contiguous(void *out, void const *data, ArrayLayout const &layout, std::size_t itemsize, bool fortran) {
+    auto to = layout.contiguous(fortran);
+    copy_array(out, to, data, layout, itemsize);
+    return to;
+}
+
+/******************************************************************************/
+
+bool ArrayNarrowing = false;
+
+namespace {
+
+/// Built-in arithmetic types with a buffer format, between which arrays are converted
+using ArrayScalars = Pack<bool, char, signed char, unsigned char, short, unsigned short, int, unsigned int,
+                          long, unsigned long, long long, unsigned long long, float, double>;
+
+std::type_info const *const array_scalars[] = {&typeid(bool), &typeid(char), &typeid(signed char),
+    &typeid(unsigned char), &typeid(short), &typeid(unsigned short), &typeid(int), &typeid(unsigned int),
+    &typeid(long), &typeid(unsigned long), &typeid(long long), &typeid(unsigned long long), &typeid(float), &typeid(double)};
+
+/// Whether every value of S is represented exactly by D
+template <class D, class S>
+constexpr bool preserves_values() {
+    using DL = std::numeric_limits<D>;
+    using SL = std::numeric_limits<S>;
+    if constexpr(std::is_same_v<S, bool>) return true;
+    else if constexpr(std::is_same_v<D, bool>) return false;
+    else if constexpr(std::is_integral_v<D>) return std::is_integral_v<S> && (DL::is_signed || !SL::is_signed) && DL::digits >= SL::digits;
+    else return DL::digits >= SL::digits; // floating point D: the mantissa must hold every value of S
+}
+
+/// On x86-64 with GCC, the contiguous loops below are compiled for both AVX2 and the baseline instruction set,
+/// and the dynamic loader picks the clone for the running CPU. Elsewhere they are compiled for the target only
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__ELF__)
+#   define REBIND_ARRAY_CLONES __attribute__((target_clones("avx2", "default")))
+#else
+#   define REBIND_ARRAY_CLONES
+#endif
+
+/// Convert n contiguous elements of S into D; values must be representable in D
+template <class D, class S>
+REBIND_ARRAY_CLONES void convert_contiguous(D *o, S const *s, std::size_t n) noexcept {
+    for (std::size_t i = 0; i != n; ++i) o[i] = static_cast<D>(s[i]);
+}
+
+/// Whether the truncation of each of n contiguous elements of S lies in [lo, hi), for integral lo and hi; false for NaN.
+/// trunc(x) >= lo is tested as x >= lo or x > lo - 1, which holds whether or not lo - 1 is representable.
+/// Quiet comparisons, no early exit, and a mask of the width of S let the loop be vectorized
+template <class S>
+REBIND_ARRAY_CLONES bool truncated_in_range(S const *s, std::size_t n, S lo, S hi) noexcept {
+    using Mask = std::conditional_t<sizeof(S) == 4, std::uint32_t, std::uint64_t>;
+    S const below = lo - 1;
+    Mask bad = 0;
+    for (std::size_t i = 0; i != n; ++i) {
+        S const x = s[i];
+        bad |= Mask(!(std::isgreaterequal(x, lo) | std::isgreater(x, below))) | Mask(!std::isless(x, hi));
+    }
+    return !bad;
+}
+
+/// Whether each of n contiguous integers of S lies in [lo, hi]. As above, the loop has no early exit so that it may be vectorized
+template <class S>
+REBIND_ARRAY_CLONES bool integers_in_range(S const *s, std::size_t n, S lo, S hi) noexcept {
+    std::make_unsigned_t<S> bad = 0;
+    for (std::size_t i = 0; i != n; ++i) bad |= (s[i] < lo) | (s[i] > hi);
+    return !bad;
+}
+
+/// Whether an integer conversion from S to D may wrap around
+template <class D, class S>
+constexpr bool integer_narrowing() {
+    if constexpr(std::is_integral_v<D> && std::is_integral_v<S> && !std::is_same_v<D, bool> && !std::is_same_v<S, bool>)
+        return !preserves_values<D, S>();
+    else return false;
+}
+
+/// Convert n elements of S spaced stride apart into contiguous D
+template <class D, class S>
+ArrayConversion convert_elements(void *out, void const *data, std::size_t n, std::ptrdiff_t stride) noexcept {
+    auto o = static_cast<D *>(out);
+    auto s = static_cast<S const *>(data);
+    if constexpr(integer_narrowing<D, S>()) {
+        // the values of D which S can hold: S is signed whenever D has lower values than S
+        using DL = std::numeric_limits<D>;
+        using SL = std::numeric_limits<S>;
+        S const hi = DL::digits >= SL::digits ? SL::max() : static_cast<S>(DL::max());
+        S const lo = !SL::is_signed || !DL::is_signed ? S(0) : DL::digits >= SL::digits ? SL::min() : static_cast<S>(DL::min());
+        if (stride != 1) {
+            for (std::size_t i = 0; i != n; ++i) {
+                S const x = s[static_cast<std::ptrdiff_t>(i) * stride];
+                if (x < lo || x > hi) return ArrayConversion::out_of_range;
+                o[i] = static_cast<D>(x);
+            }
+            return ArrayConversion::ok;
+        }
+        if (!integers_in_range(s, n, lo, hi)) return ArrayConversion::out_of_range;
+    }
+    if constexpr(std::is_integral_v<D> && !std::is_same_v<D, bool> && std::is_floating_point_v<S>) {
+        // the conversion of an out of range value is undefined, so each one is checked first
+        S const hi = std::ldexp(S(1), std::numeric_limits<D>::digits), lo = std::is_signed_v<D> ? -hi : S(0);
+        if (stride != 1) {
+            for (std::size_t i = 0; i != n; ++i) {
+                S const x = std::trunc(s[static_cast<std::ptrdiff_t>(i) * stride]);
+                if (!(x >= lo && x < hi)) return ArrayConversion::out_of_range; // also rejects NaN
+                o[i] = static_cast<D>(x);
+            }
+            return ArrayConversion::ok;
+        }
+        if (!truncated_in_range(s, n, lo, hi)) return ArrayConversion::out_of_range;
+    }
+    if (stride == 1) convert_contiguous(o, s, n);
+    else for (std::size_t i = 0; i != n; ++i) o[i] = static_cast<D>(s[static_cast<std::ptrdiff_t>(i) * stride]);
+    return ArrayConversion::ok;
+}
+
+/// Convert an array of S with any layout, gathering an N-dimensional one which is not row-major first
+template <class D, class S>
+ArrayConversion convert_layout(void *out, void const *data, ArrayLayout const &layout) {
+    std::size_t const n = layout.n_elem();
+    if (layout.depth() == 1) return convert_elements<D, S>(out, data, n, layout.stride(0));
+    if (layout.row_major()) return convert_elements<D, S>(out, data, n, 1);
+    std::unique_ptr<S[]> tmp(new S[n]);
+    copy_array(tmp.get(), layout.contiguous(), data, layout, sizeof(S));
+    return convert_elements<D, S>(out, tmp.get(), n, 1);
+}
+
+struct ArrayKernel {
+    ArrayConversion (*convert)(void *, void const *, ArrayLayout const &);
+    bool exact;
+};
+
+template <class D, class ...Ss>
+constexpr std::array<ArrayKernel, sizeof...(Ss)> array_kernel_row(Pack<Ss...>) {
+    return {{{convert_layout<D, Ss>, preserves_values<D, Ss>()}...}};
+}
+
+template <class ...Ds>
+constexpr std::array<std::array<ArrayKernel, sizeof...(Ds)>, sizeof...(Ds)> array_kernel_table(Pack<Ds...>) {
+    return {{array_kernel_row<Ds>(ArrayScalars())...}};
+}
+
+/// Conversion kernels indexed by destination and source type
+constexpr auto array_kernels = array_kernel_table(ArrayScalars());
+
+int array_scalar_index(std::type_info const &t) noexcept {
+    for (int i = 0; i != static_cast<int>(std::size(array_scalars)); ++i) if (*array_scalars[i] == t) return i;
+    return -1;
+}
+
+}
+
+ArrayConversion convert_array(void *out, std::type_info const &dest, void const *data, std::type_info const &source,
+                              ArrayLayout const &layout, bool narrow) {
+    int const d = array_scalar_index(dest), s = array_scalar_index(source);
+    if (d < 0 || s < 0) return ArrayConversion::unsupported;
+    auto const &k = array_kernels[d][s];
+    if (!k.exact && !narrow) return ArrayConversion::narrowing;
+    return k.convert(out, data, layout);
+}
+
+/******************************************************************************/
+
 void lvalue_fails(Variable const &v, Dispatch &msg, TypeIndex t) {
     char const *s = "could not convert to lvalue reference";
     if (v.type() == t) {
@@ -89,16 +403,16 @@ void Variable::assign(Variable v) {
             *this = std::move(v);
         } else {
             DUMP("assign1");
-            if (auto p = handle())
-                act(ActionType::destroy, pointer(), nullptr);
+            destroy();
             // Copy data but set the qualifier to Value
             static_cast<VariableData &>(*this) = v;
-            idx.set_qualifier(Value);
+            set_qualifier(Value);
             // DUMP(name(), qualifier(), name(), stack, v.stack);
             // DUMP(&v, v.pointer());
             // e.g. value = lvalue which means
             // Move variable if it held RValue
-            act((v.qualifier() == Rvalue) ? ActionType::move : ActionType::copy, v.pointer(), this);
+            if (v.qualifier() == Rvalue) act->move(*this, v.pointer());
+            else act->copy(*this, v.pointer());
             // DUMP(stack, v.stack);
         }
     } else if (qualifier() == Const) {
@@ -107,7 +421,7 @@ void Variable::assign(Variable v) {
     } else { // qual == Lvalue or Rvalue
         DUMP("assigning reference ", type(), " ", &buff, " ", pointer(), " ", v.type());
         // qual, type, etc are unchanged
-        act(ActionType::assign, pointer(), &v);
+        act->assign(pointer(), v);
         if (v.has_value())
             throw std::invalid_argument("Could not coerce Variable to matching type");
     }
@@ -120,26 +434,22 @@ Variable Variable::request_var(Dispatch &msg, TypeIndex const &t, Qualifier q) c
     Variable v;
     if (!has_value()) {
         // Nothing to do; request always fails
-    } else if (idx.matches(t)) { // Exact type match
-        // auto info = reinterpret_cast<std::type_info const * const &>(t);
+    } else if (matches(t)) { // Exact type match
         if (t.qualifier() == Value) { // Make a copy or move
-            v.idx = t;
+            v.set_index(t, stack());
             v.act = act;
-            v.stack = stack;
-            act((q == Rvalue) ? ActionType::move : ActionType::copy, pointer(), &v);
+            if (q == Rvalue) act->move(v, pointer());
+            else act->copy(v, pointer());
         } else if (t.qualifier() == Const || t.qualifier() == q) { // Bind a reference
-            // DUMP("yope", t, type(), q);
             reinterpret_cast<void *&>(v.buff) = pointer();
-            v.idx = t;
+            v.set_index(t, stack());
             v.act = act;
-            v.stack = stack;
         } else {
             // DUMP("nope");
             msg.error("Source and target qualifiers are not compatible");
         }
     } else {
-        ::new(static_cast<void *>(&v.buff)) RequestData{t, &msg, q};
-        act(ActionType::response, pointer(), &v);
+        act->response(v, pointer(), RequestData{t, &msg, q});
         // DUMP(v.has_value(), v.name(), q, v.qualifier());
 
         if (!v.has_value()) {
@@ -157,18 +467,162 @@ Variable Variable::request_var(Dispatch &msg, TypeIndex const &t, Qualifier q) c
 
 /******************************************************************************/
 
+namespace {
+    /// Per-thread arena of conversion temporaries, reset when no Dispatch is alive
+    struct TemporaryArena {
+        static constexpr std::size_t ChunkSize = 4096;
+        Vector<std::unique_ptr<char[]>> chunks, large;
+        std::size_t chunk = 0, offset = 0, depth = 0;
+
+        void *allocate(std::size_t n, std::size_t a) {
+            if (n + a > ChunkSize / 4) { // give large temporaries their own memory
+                large.emplace_back(new char[n + a]);
+                return align(large.back().get(), a);
+            }
+            if (chunks.empty()) chunks.emplace_back(new char[ChunkSize]);
+            auto p = align(chunks[chunk].get() + offset, a);
+            if (p + n > chunks[chunk].get() + ChunkSize) {
+                if (++chunk == chunks.size()) chunks.emplace_back(new char[ChunkSize]);
+                p = align(chunks[chunk].get(), a);
+            }
+            offset = p + n - chunks[chunk].get();
+            return p;
+        }
+
+        static char *align(char *p, std::size_t a) noexcept {
+            return reinterpret_cast<char *>((reinterpret_cast<std::uintptr_t>(p) + a - 1) & ~std::uintptr_t(a - 1));
+        }
+
+        void reset() noexcept {
+            chunk = offset = 0;
+            large.clear();
+        }
+    };
+
+    thread_local TemporaryArena temporary_arena;
+}
+
+void *allocate_temporary(std::size_t n, std::size_t a) {return temporary_arena.allocate(n, a);}
+
+char const *copy_temporary(std::string_view s) {
+    auto p = static_cast<char *>(allocate_temporary(s.size() + 1, 1));
+    std::copy(s.begin(), s.end(), p)[0] = 0;
+    return p;
+}
+
+Dispatch::Dispatch(Caller c, char const *s) noexcept : scope(s), caller(std::move(c)) {++temporary_arena.depth;}
+
+Dispatch::~Dispatch() {
+    for (auto t = temporaries; t; t = t->next) t->destroy(t->object);
+    if (!--temporary_arena.depth) temporary_arena.reset();
+}
+
+/******************************************************************************/
+
+namespace {
+    struct RouteKey {
+        std::type_info const *held, *requested;
+        Qualifier requested_qualifier, source;
+
+        bool operator==(RouteKey const &k) const noexcept {
+            return held == k.held && requested == k.requested
+                && requested_qualifier == k.requested_qualifier && source == k.source;
+        }
+    };
+
+    struct RouteHash {
+        std::size_t operator()(RouteKey const &k) const noexcept {
+            auto h = reinterpret_cast<std::uintptr_t>(k.held) * 31 + reinterpret_cast<std::uintptr_t>(k.requested);
+            return std::hash<std::uintptr_t>()(h * 8 + k.requested_qualifier * 4 + k.source);
+        }
+    };
+
+    std::shared_mutex route_mutex;
+    std::unordered_map<RouteKey, Route, RouteHash> routes;
+
+    /// Recently used routes of this thread, to avoid taking the lock in the common case
+    thread_local std::pair<RouteKey, Route> recent_routes[64];
+
+    std::pair<RouteKey, Route> & recent_route(RouteKey const &k) noexcept {
+        return recent_routes[RouteHash()(k) % std::size(recent_routes)];
+    }
+}
+
+Route find_route(std::type_info const &held, TypeIndex const &t, Qualifier source) noexcept {
+    RouteKey const k{&held, &t.info(), t.qualifier(), source};
+    auto &recent = recent_route(k);
+    if (recent.second != Route::unknown && recent.first == k) return recent.second;
+    std::shared_lock<std::shared_mutex> lock(route_mutex);
+    auto it = routes.find(k);
+    if (it == routes.end()) return Route::unknown;
+    recent = *it;
+    return it->second;
+}
+
+void store_route(std::type_info const &held, TypeIndex const &t, Qualifier source, Route r) {
+    RouteKey const k{&held, &t.info(), t.qualifier(), source};
+    {
+        std::unique_lock<std::shared_mutex> lock(route_mutex);
+        routes.insert_or_assign(k, r);
+    }
+    recent_route(k) = {k, r};
+}
+
+/******************************************************************************/
+
+/// Set the source description from a failed Response, which may have put a Description or a string into v
 void set_source(Dispatch &msg, std::type_info const &t, Variable &&v) {
-    if (auto p = std::move(v).target<std::string &&>()) {
-        msg.source = std::move(*p);
-    } else if (auto p = v.target<std::string_view const &>()) {
+    if (auto p = v.target<Description const &>()) {
         msg.source = *p;
     } else if (auto p = v.target<TypeIndex const &>()) {
-        msg.source = p->name();
+        msg.source = Description::of(p->info());
+    } else if (auto p = v.target<std::string const &>()) {
+        msg.source = {copy_temporary(*p)};
+    } else if (auto p = v.target<std::string_view const &>()) {
+        msg.source = {copy_temporary(*p)};
     } else {
-        msg.source = t.name();
+        msg.source = {t.name()};
+    }
+}
+
+/******************************************************************************/
+
+void OverloadIndex::insert(OverloadKey const &k) {
+    keys.emplace_back(k);
+    hits.emplace_back(0);
+    reorder();
+}
+
+void OverloadIndex::reorder() {
+    std::size_t top = 0; // one past the largest bounded number of arguments
+    for (auto const &o : keys)
+        top = std::max(top, 1 + (o.max_args == std::size_t(-1) ? o.min_args : o.max_args));
+    buckets.assign(top + 1, {});
+    for (std::size_t n = 0; n != buckets.size(); ++n) {
+        auto &b = buckets[n];
+        for (unsigned int i = 0; i != keys.size(); ++i)
+            if (keys[i].min_args <= n && n <= keys[i].max_args) b.all.emplace_back(i);
+        std::stable_sort(b.all.begin(), b.all.end(), [&](auto i, auto j) {return hits[i] > hits[j];});
+        for (auto i : b.all) {
+            auto const t = keys[i].leading;
+            if (!t || std::any_of(b.leading.begin(), b.leading.end(), [t](auto const &p) {return p.first == t;})) continue;
+            // overloads of unknown leading type are kept with the exact matches, as they may accept anything
+            auto exact = [&](unsigned int j) {return !keys[j].leading || keys[j].leading == t;};
+            auto &order = b.leading.emplace_back(t, Vector<unsigned int>()).second;
+            std::copy_if(b.all.begin(), b.all.end(), std::back_inserter(order), exact);
+            std::copy_if(b.all.begin(), b.all.end(), std::back_inserter(order), [&](auto j) {return !exact(j);});
+        }
     }
 }
 
+Vector<unsigned int> const & OverloadIndex::candidates(std::size_t n, std::type_info const *leading) const noexcept {
+    static Vector<unsigned int> const none;
+    if (buckets.empty()) return none;
+    auto const &b = buckets[std::min(n, buckets.size() - 1)];
+    for (auto const &p : b.leading) if (p.first == leading) return p.second;
+    return b.all;
+}
+
 /******************************************************************************/
 
 TypeData & Document::type(TypeIndex t, std::string s, Variable data) {
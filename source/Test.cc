@@ -1,6 +1,6 @@
 
 #include <rebind/Document.h>
-#include <rebind/Standard.h>
+#include <rebind/StandardTypes.h>
 #include <iostream>
 
 namespace rebind {
@@ -108,7 +108,7 @@ bool make_document() {
         DUMP(std::get<0>(i).size());
         DUMP(std::get<1>(i).name());
         DUMP(std::get<2>(i).size());
-        for (auto &c : std::get<0>(i)) c += 4;
+        for (auto &c : std::get<0>(i)) c = std::byte(int(c) + 4);
     });
     doc.function("vec1", [](std::vector<int> const &) {});
     doc.function("vec2", [](std::vector<int> &) {});
@@ -120,4 +120,6 @@ bool make_document() {
 // then this is just add_document()
 static bool static_document_trigger = make_document();
 
+void init(Document &) {}
+
 }
@@ -3,10 +3,17 @@ namespace rebind {
 // move_from is called 1) during init, V.move_from(V), to transfer the object (here just use Var move constructor)
 //                     2) during assignment, R.move_from(L), to transfer the object (here cast V to new object of same type, swap)
 //                     2) during assignment, R.move_from(V), to transfer the object (here cast V to new object of same type, swap)
+inline Object exported_error() {
+    PyErr_SetString(PyExc_BufferError, "C++: cannot assign to a Variable whose buffer is exported");
+    return {};
+}
+
 PyObject * var_copy_assign(PyObject *self, PyObject *value) noexcept {
     return raw_object([=] {
         DUMP("- copying variable");
-        cast_object<Var>(self).assign(variable_reference_from_object({value, true}));
+        auto &s = cast_object<Var>(self);
+        if (s.exports) return exported_error();
+        s.assign(variable_reference_from_object({value, true}));
         return Object(self, true);
     });
 }
@@ -15,6 +22,7 @@ PyObject * var_move_assign(PyObject *self, PyObject *value) noexcept {
     return raw_object([=] {
         DUMP("- moving variable");
         auto &s = cast_object<Var>(self);
+        if (s.exports) return exported_error();
         Variable v = variable_reference_from_object({value, true});
         v.move_if_lvalue();
         s.assign(std::move(v));
@@ -38,7 +46,10 @@ PyObject * var_has_value(PyObject *self, PyObject *) noexcept {
 
 PyObject * var_cast(PyObject *self, PyObject *type) noexcept {
     return raw_object([=] {
-        return python_cast(std::move(cast_object<Variable>(self)), Object(type, true), Object(self, true));
+        auto &v = cast_object<Var>(self);
+        if (v.exports) // the exported value may not be moved from
+            return python_cast(static_cast<Variable const &>(v).reference(), Object(type, true), Object(self, true));
+        return python_cast(std::move(v), Object(type, true), Object(self, true));
     });
 }
 
@@ -105,6 +116,74 @@ PyObject * var_from(PyObject *cls, PyObject *obj) noexcept {
 
 /******************************************************************************/
 
+/// Contiguous array owned by a held C++ container
+struct OwnedArray {
+    void *data;
+    Py_ssize_t size;
+    std::type_info const *type;
+};
+
+template <class V, class T=typename V::value_type>
+OwnedArray owned_array(void *p) {
+    auto &v = *static_cast<V *>(p);
+    return {v.data(), static_cast<Py_ssize_t>(v.size()), &typeid(T)};
+}
+
+using OwnedArrays = std::unordered_map<std::type_index, OwnedArray (*)(void *)>;
+
+template <class ...Ts>
+OwnedArrays make_owned_arrays(Pack<Ts...>) {
+    return {{typeid(std::vector<Ts>), owned_array<std::vector<Ts>>}..., {typeid(Binary), owned_array<Binary, unsigned char>}};
+}
+
+/// Containers whose contents are exported through the buffer protocol by a Variable holding them by value
+OwnedArrays const owned_arrays = make_owned_arrays(Pack<char, signed char, unsigned char, short, unsigned short,
+    int, unsigned int, long, unsigned long, long long, unsigned long long, float, double>());
+
+/// Export the contents of an owned container without copying. The shape and stride are kept in view->internal
+int var_buffer(PyObject *self, Py_buffer *view, int flags) noexcept {
+    auto &v = cast_object<Var>(self);
+    auto it = v.qualifier() == Value ? owned_arrays.find(v.type().info()) : owned_arrays.end();
+    if (it == owned_arrays.end()) {
+        PyErr_SetString(PyExc_BufferError, "C++: Variable does not own a contiguous array");
+        return view->obj = nullptr, -1;
+    }
+    if (!v.exports) v.reference(); // make a private copy of a shared payload before its address is lent out
+    auto const a = it->second(const_cast<void *>(v.data()));
+    auto const item = static_cast<Py_ssize_t>(Buffer::itemsize(*a.type));
+    auto shape = new (std::nothrow) Py_ssize_t[2]{a.size, item};
+    if (!shape) return view->obj = nullptr, PyErr_NoMemory(), -1;
+    view->buf = a.data;
+    view->obj = self;
+    view->len = a.size * item;
+    view->itemsize = item;
+    view->readonly = 0;
+    view->format = (flags & PyBUF_FORMAT) ? const_cast<char *>(Buffer::format(*a.type).data()) : nullptr;
+    view->ndim = 1;
+    view->shape = shape;
+    view->strides = shape + 1;
+    view->suboffsets = nullptr;
+    view->internal = shape;
+    ++v.exports;
+    incref(self);
+    return 0;
+}
+
+void var_release(PyObject *self, Py_buffer *view) noexcept {
+    --cast_object<Var>(self).exports;
+    delete[] static_cast<Py_ssize_t *>(view->internal);
+}
+
+PyBufferProcs VarBufferProcs{var_buffer, var_release};
+
+/// Whether v is the value held by a Variable which owns it as a contiguous array
+bool is_owned_array(Variable const &v, Object const &root) {
+    auto p = cast_if<Var>(root);
+    return p && p->qualifier() == Value && p->data() == v.data() && owned_arrays.count(p->type().info());
+}
+
+/******************************************************************************/
+
 PyNumberMethods VarNumberMethods = {
     .nb_bool = static_cast<inquiry>(var_bool),
 };
@@ -128,6 +207,7 @@ template <>
 PyTypeObject Holder<Var>::type = []{
     auto o = type_definition<Var>("rebind.Variable", "C++ class object");
     o.tp_as_number = &VarNumberMethods;
+    o.tp_as_buffer = &VarBufferProcs;
     o.tp_methods = VarMethods;
     // no init (just use default constructor)
     // tp_traverse, tp_clear